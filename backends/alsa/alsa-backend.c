@@ -15,10 +15,19 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "config.h"
+
+#include <unistd.h>
 #include <glib.h>
 #include <glib-object.h>
+#include <glib-unix.h>
+#include <gio/gio.h>
 #include <alsa/asoundlib.h>
 
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+
 #include <libcafemixer/cafemixer.h>
 #include <libcafemixer/cafemixer-private.h>
 
@@ -30,6 +39,13 @@
 #define BACKEND_PRIORITY  20
 #define BACKEND_FLAGS     CAFE_MIXER_BACKEND_NO_FLAGS
 
+/* Directory with the sound card device nodes, each card has a control device */
+#define ALSA_DEV_DIR            "/dev/snd"
+#define ALSA_DEV_CONTROL_PREFIX "controlC"
+
+/* Identifier of a sound card, this is the same as the card info id */
+#define ALSA_PROC_CARD_ID_FILE  "/proc/asound/card%d/id"
+
 #define ALSA_DEVICE_GET_ID(d)                                               \
         (g_object_get_data (G_OBJECT (d), "__cafemixer_alsa_device_id"))
 
@@ -39,12 +55,29 @@
                                  g_strdup (id),                             \
                                  g_free))
 
+/* Result of probing a sound card in a worker thread */
+typedef struct {
+    gchar       *card;
+    gchar       *id;
+    gchar       *label;
+    snd_mixer_t *handle;
+    guint        index;
+} AlsaProbe;
+
 struct _AlsaBackendPrivate
 {
-    GSource    *timeout_source;
-    GList      *streams;
-    GList      *devices;
-    GHashTable *devices_ids;
+    GSource      *timeout_source;
+    GSource      *hotplug_source;
+    gint          hotplug_fd;
+    GCancellable *probe_cancellable;
+    guint         probes;
+    GPtrArray    *probe_results;
+    guint         probes_published;
+    gboolean      rescan;
+    GList        *streams;
+    GList        *devices;
+    GHashTable   *devices_ids;
+    GHashTable   *cards;
 };
 
 static void alsa_backend_dispose        (GObject          *object);
@@ -61,11 +94,45 @@ static void         alsa_backend_close           (CafeMixerBackend *backend);
 static const GList *alsa_backend_list_devices    (CafeMixerBackend *backend);
 static const GList *alsa_backend_list_streams    (CafeMixerBackend *backend);
 
+static gboolean     start_hotplug_watch          (AlsaBackend      *alsa);
+static void         stop_hotplug_watch           (AlsaBackend      *alsa);
+static void         start_poll_timer             (AlsaBackend      *alsa);
+static gboolean     poll_devices                 (AlsaBackend      *alsa);
+
+#ifdef HAVE_SYS_INOTIFY_H
+static gboolean     read_hotplug_events          (gint              fd,
+                                                  GIOCondition      condition,
+                                                  AlsaBackend      *alsa);
+#endif
+
+static void         probe_devices                (AlsaBackend      *alsa);
+static void         start_probe                  (AlsaBackend      *alsa,
+                                                  const gchar      *card);
+static void         probe_thread                 (GTask            *task,
+                                                  gpointer          source_object,
+                                                  gpointer          task_data,
+                                                  GCancellable     *cancellable);
+static void         probe_done                   (AlsaBackend      *alsa,
+                                                  GAsyncResult     *result,
+                                                  gpointer          user_data);
+static void         add_probed_device            (AlsaBackend      *alsa,
+                                                  AlsaProbe        *probe);
+static void         stop_probing                 (AlsaBackend      *alsa);
+static void         probe_free                   (AlsaProbe        *probe);
+
 static gboolean     read_devices                 (AlsaBackend      *alsa);
 
 static gboolean     read_device                  (AlsaBackend      *alsa,
                                                   const gchar      *card);
 
+static gchar *      read_card_id                 (gint              num);
+static void         remember_card                (AlsaBackend      *alsa,
+                                                  const gchar      *card,
+                                                  const gchar      *id);
+static gboolean     card_has_id                  (gpointer          num,
+                                                  const gchar      *card_id,
+                                                  const gchar      *id);
+
 static void         add_device                   (AlsaBackend      *alsa,
                                                   AlsaDevice       *device);
 
@@ -76,6 +143,9 @@ static void         remove_device_by_name        (AlsaBackend      *alsa,
 static void         remove_device_by_list_item   (AlsaBackend      *alsa,
                                                   GList            *item);
 
+static void         add_stream                   (AlsaBackend      *alsa,
+                                                  const gchar      *name,
+                                                  AlsaDevice       *device);
 static void         remove_stream                (AlsaBackend      *alsa,
                                                   const gchar      *name);
 
@@ -136,10 +206,18 @@ alsa_backend_init (AlsaBackend *alsa)
 {
     alsa->priv = alsa_backend_get_instance_private (alsa);
 
+    alsa->priv->hotplug_fd = -1;
+
     alsa->priv->devices_ids = g_hash_table_new_full (g_str_hash,
                                                      g_str_equal,
                                                      g_free,
                                                      NULL);
+
+    /* Identifiers of the known sound cards by their numbers */
+    alsa->priv->cards = g_hash_table_new_full (g_direct_hash,
+                                               g_direct_equal,
+                                               NULL,
+                                               g_free);
 }
 
 static void
@@ -165,6 +243,7 @@ alsa_backend_finalize (GObject *object)
     alsa = ALSA_BACKEND (object);
 
     g_hash_table_unref (alsa->priv->devices_ids);
+    g_hash_table_unref (alsa->priv->cards);
 
     G_OBJECT_CLASS (alsa_backend_parent_class)->finalize (object);
 }
@@ -178,22 +257,23 @@ alsa_backend_open (CafeMixerBackend *backend)
 
     alsa = ALSA_BACKEND (backend);
 
-    /* Poll ALSA for changes every second, this only discovers added or removed
-     * sound cards, sound card related events are handled by AlsaDevices */
-    alsa->priv->timeout_source = g_timeout_source_new_seconds (1);
-    g_source_set_callback (alsa->priv->timeout_source,
-                           (GSourceFunc) read_devices,
-                           alsa,
-                           NULL);
-    g_source_attach (alsa->priv->timeout_source,
-                     g_main_context_get_thread_default ());
+    /* Watch the sound card device nodes to discover added or removed sound
+     * cards, sound card related events are handled by AlsaDevices. If this is
+     * not possible, poll ALSA for changes every second instead */
+    if (start_hotplug_watch (alsa) == FALSE) {
+        g_debug ("Failed to watch %s, polling for sound card changes", ALSA_DEV_DIR);
+
+        start_poll_timer (alsa);
+    }
 
     /* Read the initial list of devices so we have some starting point, there
      * isn't really a way to detect errors here, failing to add a device may
-     * be a device-related problem so make the backend always open successfully */
-    read_devices (alsa);
+     * be a device-related problem so make the backend always open successfully.
+     * The cards are probed in worker threads and the backend becomes ready
+     * once the default device has been probed */
+    _cafe_mixer_backend_set_state (backend, CAFE_MIXER_STATE_CONNECTING);
 
-    _cafe_mixer_backend_set_state (backend, CAFE_MIXER_STATE_READY);
+    probe_devices (alsa);
     return TRUE;
 }
 
@@ -206,7 +286,13 @@ alsa_backend_close (CafeMixerBackend *backend)
 
     alsa = ALSA_BACKEND (backend);
 
-    g_source_destroy (alsa->priv->timeout_source);
+    stop_probing (alsa);
+    stop_hotplug_watch (alsa);
+
+    if (alsa->priv->timeout_source != NULL) {
+        g_source_destroy (alsa->priv->timeout_source);
+        g_clear_pointer (&alsa->priv->timeout_source, g_source_unref);
+    }
 
     if (alsa->priv->devices != NULL) {
         g_list_free_full (alsa->priv->devices, g_object_unref);
@@ -216,6 +302,7 @@ alsa_backend_close (CafeMixerBackend *backend)
     free_stream_list (alsa);
 
     g_hash_table_remove_all (alsa->priv->devices_ids);
+    g_hash_table_remove_all (alsa->priv->cards);
 
     _cafe_mixer_backend_set_state (backend, CAFE_MIXER_STATE_IDLE);
 }
@@ -237,31 +324,384 @@ alsa_backend_list_streams (CafeMixerBackend *backend)
 
     alsa = ALSA_BACKEND (backend);
 
-    if (alsa->priv->streams == NULL) {
-        GList *list;
+    /* The list is kept up to date as devices add and remove their streams */
+    return alsa->priv->streams;
+}
 
-        /* Walk through the list of devices and create the stream list, each
-         * device has at most one input and one output stream */
-        list = g_list_last (alsa->priv->devices);
+static gboolean
+start_hotplug_watch (AlsaBackend *alsa G_GNUC_UNUSED)
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    gint fd;
 
-        while (list != NULL) {
-            AlsaDevice *device = ALSA_DEVICE (list->data);
-            AlsaStream *stream;
+    fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return FALSE;
 
-            stream = alsa_device_get_output_stream (device);
-            if (stream != NULL)
-                alsa->priv->streams =
-                    g_list_prepend (alsa->priv->streams, g_object_ref (stream));
+    /* Access permissions of a new device node are often only set up after
+     * the node is created, so watch for attribute changes as well.
+     * The directory itself may be removed together with the last card */
+    if (inotify_add_watch (fd,
+                           ALSA_DEV_DIR,
+                           IN_CREATE | IN_DELETE | IN_ATTRIB |
+                           IN_DELETE_SELF | IN_MOVE_SELF) < 0) {
+        close (fd);
+        return FALSE;
+    }
 
-            stream = alsa_device_get_input_stream (device);
-            if (stream != NULL)
-                alsa->priv->streams =
-                    g_list_prepend (alsa->priv->streams, g_object_ref (stream));
+    alsa->priv->hotplug_fd = fd;
+    alsa->priv->hotplug_source = g_unix_fd_source_new (fd, G_IO_IN);
 
-            list = list->prev;
+    g_source_set_callback (alsa->priv->hotplug_source,
+                           (GSourceFunc) read_hotplug_events,
+                           alsa,
+                           NULL);
+    g_source_attach (alsa->priv->hotplug_source,
+                     g_main_context_get_thread_default ());
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+static void
+stop_hotplug_watch (AlsaBackend *alsa)
+{
+    if (alsa->priv->hotplug_source != NULL) {
+        g_source_destroy (alsa->priv->hotplug_source);
+        g_clear_pointer (&alsa->priv->hotplug_source, g_source_unref);
+    }
+
+    if (alsa->priv->hotplug_fd != -1) {
+        close (alsa->priv->hotplug_fd);
+        alsa->priv->hotplug_fd = -1;
+    }
+}
+
+static void
+start_poll_timer (AlsaBackend *alsa)
+{
+    alsa->priv->timeout_source = g_timeout_source_new_seconds (1);
+    g_source_set_callback (alsa->priv->timeout_source,
+                           (GSourceFunc) poll_devices,
+                           alsa,
+                           NULL);
+    g_source_attach (alsa->priv->timeout_source,
+                     g_main_context_get_thread_default ());
+}
+
+static gboolean
+poll_devices (AlsaBackend *alsa)
+{
+    /* Go back to watching the device nodes once the directory exists again,
+     * the watch is set up first so no card can be missed in between */
+    if (start_hotplug_watch (alsa) == TRUE) {
+        g_debug ("Watching %s for sound card changes", ALSA_DEV_DIR);
+
+        g_clear_pointer (&alsa->priv->timeout_source, g_source_unref);
+
+        read_devices (alsa);
+        return G_SOURCE_REMOVE;
+    }
+    return read_devices (alsa);
+}
+
+#ifdef HAVE_SYS_INOTIFY_H
+static gboolean
+read_hotplug_events (gint fd, GIOCondition condition, AlsaBackend *alsa)
+{
+    union {
+        struct inotify_event event;
+        gchar                buffer[4096];
+    } events;
+    gssize   len;
+    gboolean changed = FALSE;
+    gboolean lost = FALSE;
+
+    if (condition & (G_IO_ERR | G_IO_HUP)) {
+        /* Should not happen, but keep discovering the cards anyway */
+        g_clear_pointer (&alsa->priv->hotplug_source, g_source_unref);
+        stop_hotplug_watch (alsa);
+
+        start_poll_timer (alsa);
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Drain all the queued events, a card usually produces several of them,
+     * but the devices only need to be read once */
+    while ((len = read (fd, &events, sizeof (events))) > 0) {
+        gssize offset = 0;
+
+        while (offset < len) {
+            const struct inotify_event *event =
+                (const struct inotify_event *) (events.buffer + offset);
+
+            if ((event->mask & IN_Q_OVERFLOW) ||
+                (event->len > 0 &&
+                 g_str_has_prefix (event->name, ALSA_DEV_CONTROL_PREFIX) == TRUE))
+                changed = TRUE;
+
+            /* The watched directory is gone and so is the watch */
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+                lost = TRUE;
+
+            offset += sizeof (struct inotify_event) + event->len;
         }
     }
-    return alsa->priv->streams;
+
+    if (lost == TRUE) {
+        g_debug ("%s has been removed, polling for sound card changes",
+                 ALSA_DEV_DIR);
+
+        g_clear_pointer (&alsa->priv->hotplug_source, g_source_unref);
+        stop_hotplug_watch (alsa);
+
+        /* The timer switches back to the watch when the directory reappears */
+        start_poll_timer (alsa);
+        changed = TRUE;
+    }
+
+    if (changed == TRUE)
+        read_devices (alsa);
+
+    return (lost == TRUE) ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+}
+#endif
+
+static void
+probe_devices (AlsaBackend *alsa)
+{
+    gint  num;
+    gchar card[16];
+
+    alsa->priv->probe_cancellable = g_cancellable_new ();
+    alsa->priv->probe_results     = g_ptr_array_new_with_free_func ((GDestroyNotify) probe_free);
+
+    /* The default device is published first, same as in read_devices () */
+    start_probe (alsa, "default");
+
+    for (num = -1;;) {
+        if (snd_card_next (&num) < 0 || num < 0)
+            break;
+
+        g_snprintf (card, sizeof (card), "hw:%d", num);
+
+        start_probe (alsa, card);
+    }
+}
+
+static void
+start_probe (AlsaBackend *alsa, const gchar *card)
+{
+    GTask     *task;
+    AlsaProbe *probe;
+
+    /* The results are published in the order in which the probes are
+     * started, each probe has its slot in the array */
+    probe = g_slice_new0 (AlsaProbe);
+    probe->card  = g_strdup (card);
+    probe->index = alsa->priv->probe_results->len;
+
+    g_ptr_array_add (alsa->priv->probe_results, NULL);
+
+    task = g_task_new (alsa,
+                       alsa->priv->probe_cancellable,
+                       (GAsyncReadyCallback) probe_done,
+                       NULL);
+
+    g_task_set_task_data (task, probe, (GDestroyNotify) probe_free);
+    g_task_run_in_thread (task, probe_thread);
+    g_object_unref (task);
+
+    alsa->priv->probes++;
+}
+
+static void
+probe_thread (GTask        *task,
+              gpointer      source_object G_GNUC_UNUSED,
+              gpointer      task_data,
+              GCancellable *cancellable G_GNUC_UNUSED)
+{
+    AlsaProbe           *probe = task_data;
+    snd_ctl_t           *ctl;
+    snd_ctl_card_info_t *info;
+    gint                 ret;
+
+    /* Only the sound card is touched here, the devices are created in the
+     * main context when the probe is finished */
+    G_LOCK (alsa_config);
+    ret = snd_ctl_open (&ctl, probe->card, 0);
+    G_UNLOCK (alsa_config);
+
+    if (ret < 0) {
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                                 "%s", snd_strerror (ret));
+        return;
+    }
+
+    snd_ctl_card_info_alloca (&info);
+
+    ret = snd_ctl_card_info (ctl, info);
+    if (ret < 0) {
+        g_warning ("Failed to read card info: %s", snd_strerror (ret));
+
+        snd_ctl_close (ctl);
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                                 "%s", snd_strerror (ret));
+        return;
+    }
+
+    probe->id    = g_strdup (snd_ctl_card_info_get_id (info));
+    probe->label = g_strdup (snd_ctl_card_info_get_name (info));
+
+    snd_ctl_close (ctl);
+
+    if (g_task_return_error_if_cancelled (task) == TRUE)
+        return;
+
+    g_debug ("Opening device %s (%s)", probe->card, probe->label);
+
+    /* Loading the mixer elements is the slow part of reading a card */
+    probe->handle = alsa_device_open_mixer (probe->card);
+    if (probe->handle == NULL) {
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                                 "Failed to open mixer of %s", probe->card);
+        return;
+    }
+
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+probe_done (AlsaBackend  *alsa,
+            GAsyncResult *result,
+            gpointer      user_data G_GNUC_UNUSED)
+{
+    AlsaProbe *probe;
+    AlsaProbe *slot;
+
+    /* The backend has been closed since the probe was started, the probe is
+     * freed together with the task */
+    if (g_task_get_cancellable (G_TASK (result)) != alsa->priv->probe_cancellable)
+        return;
+
+    probe = g_task_get_task_data (G_TASK (result));
+
+    /* Take over the result, a failed probe leaves an empty slot */
+    slot = g_slice_new0 (AlsaProbe);
+    slot->card  = g_strdup (probe->card);
+    slot->index = probe->index;
+
+    if (g_task_propagate_boolean (G_TASK (result), NULL) == TRUE) {
+        slot->id     = probe->id;
+        slot->label  = probe->label;
+        slot->handle = probe->handle;
+
+        probe->id     = NULL;
+        probe->label  = NULL;
+        probe->handle = NULL;
+
+        remember_card (alsa, slot->card, slot->id);
+    }
+
+    g_ptr_array_index (alsa->priv->probe_results, slot->index) = slot;
+
+    alsa->priv->probes--;
+
+    /* Publish the cards in the order they were started, which is the default
+     * device first and then the cards by their index, a card which finished
+     * early waits for the ones before it. The default device may be the same
+     * card as one of the others and it takes precedence */
+    while (alsa->priv->probes_published < alsa->priv->probe_results->len) {
+        slot = g_ptr_array_index (alsa->priv->probe_results,
+                                  alsa->priv->probes_published);
+        if (slot == NULL)
+            break;
+
+        alsa->priv->probes_published++;
+
+        if (slot->handle != NULL) {
+            add_probed_device (alsa, slot);
+
+            /* A signal handler may have closed the backend */
+            if (alsa->priv->probe_results == NULL)
+                return;
+        }
+    }
+
+    /* The default device is the first one */
+    if (alsa->priv->probes_published > 0 &&
+        cafe_mixer_backend_get_state (CAFE_MIXER_BACKEND (alsa)) == CAFE_MIXER_STATE_CONNECTING)
+        _cafe_mixer_backend_set_state (CAFE_MIXER_BACKEND (alsa), CAFE_MIXER_STATE_READY);
+
+    if (alsa->priv->probes == 0) {
+        g_clear_object (&alsa->priv->probe_cancellable);
+        g_clear_pointer (&alsa->priv->probe_results, g_ptr_array_unref);
+
+        alsa->priv->probes_published = 0;
+
+        /* Sound cards may have changed while they were being probed */
+        if (alsa->priv->rescan == TRUE) {
+            alsa->priv->rescan = FALSE;
+            read_devices (alsa);
+        }
+    }
+}
+
+static void
+add_probed_device (AlsaBackend *alsa, AlsaProbe *probe)
+{
+    AlsaDevice *device;
+
+    /* We also keep a list of device identifiers to be sure no card is
+     * added twice, this could commonly happen because some card may
+     * also be assigned to the "default" ALSA device */
+    if (g_hash_table_contains (alsa->priv->devices_ids, probe->id) == TRUE)
+        return;
+
+    device = alsa_device_new (probe->card, probe->label);
+
+    /* The device takes ownership of the mixer */
+    alsa_device_open_with_mixer (device, probe->handle);
+    probe->handle = NULL;
+
+    ALSA_DEVICE_SET_ID (device, probe->id);
+    add_device (alsa, device);
+
+    select_default_input_stream (alsa);
+    select_default_output_stream (alsa);
+}
+
+static void
+stop_probing (AlsaBackend *alsa)
+{
+    if (alsa->priv->probe_cancellable != NULL) {
+        g_cancellable_cancel (alsa->priv->probe_cancellable);
+        g_clear_object (&alsa->priv->probe_cancellable);
+    }
+
+    g_clear_pointer (&alsa->priv->probe_results, g_ptr_array_unref);
+
+    alsa->priv->probes           = 0;
+    alsa->priv->probes_published = 0;
+    alsa->priv->rescan           = FALSE;
+}
+
+static void
+probe_free (AlsaProbe *probe)
+{
+    /* Slots of the probes which have not finished are empty */
+    if (probe == NULL)
+        return;
+
+    if (probe->handle != NULL)
+        snd_mixer_close (probe->handle);
+
+    g_free (probe->card);
+    g_free (probe->id);
+    g_free (probe->label);
+
+    g_slice_free (AlsaProbe, probe);
 }
 
 static gboolean
@@ -272,22 +712,55 @@ read_devices (AlsaBackend *alsa)
     gchar    card[16];
     gboolean added = FALSE;
 
+    /* Cards are read again when the initial probing finishes */
+    if (alsa->priv->probes > 0) {
+        alsa->priv->rescan = TRUE;
+        return G_SOURCE_CONTINUE;
+    }
+
     /* Read the default device first, it will be either one of the hardware cards
-     * that will be queried later, or a software mixer */
-    if (read_device (alsa, "default") == TRUE)
+     * that will be queried later, or a software mixer.
+     * Once it is present, it is removed along with its card, so it does not
+     * need to be opened again */
+    if (g_list_find_custom (alsa->priv->devices, "default", compare_device_name) == NULL &&
+        read_device (alsa, "default") == TRUE)
         added = TRUE;
 
     for (num = -1;;) {
+        const gchar *known_id;
+        gchar       *id;
+
         /* Read number of the next sound card */
         ret = snd_card_next (&num);
         if (ret < 0 ||
             num < 0)
             break;
 
+        /* Cards which are already known to be present are skipped without
+         * touching them, a removed card closes its device and is forgotten */
+        known_id = g_hash_table_lookup (alsa->priv->cards, GINT_TO_POINTER (num));
+        if (known_id != NULL &&
+            g_hash_table_contains (alsa->priv->devices_ids, known_id) == TRUE)
+            continue;
+
         g_snprintf (card, sizeof (card), "hw:%d", num);
 
-        if (read_device (alsa, card) == TRUE)
+        /* Avoid opening the card if its identifier is enough to find out that
+         * it is already known, e.g. through the "default" device */
+        id = read_card_id (num);
+        if (id != NULL && g_hash_table_contains (alsa->priv->devices_ids, id) == TRUE) {
+            remember_card (alsa, card, id);
+            g_free (id);
+            continue;
+        }
+
+        if (read_device (alsa, card) == TRUE) {
             added = TRUE;
+
+            if (id != NULL)
+                remember_card (alsa, card, id);
+        }
+        g_free (id);
     }
 
     /* If any card has been added, make sure we have the most suitable default
@@ -316,7 +789,10 @@ read_device (AlsaBackend *alsa, const gchar *card)
      * reassigned by ALSA when the sound card is removed or the sound mixer
      * quits.
     */
+    G_LOCK (alsa_config);
     ret = snd_ctl_open (&ctl, card, 0);
+    G_UNLOCK (alsa_config);
+
     if (ret < 0) {
         remove_device_by_name (alsa, card);
         return FALSE;
@@ -358,6 +834,47 @@ read_device (AlsaBackend *alsa, const gchar *card)
     return TRUE;
 }
 
+static gchar *
+read_card_id (gint num)
+{
+    gchar *path;
+    gchar *id = NULL;
+
+    /* Reading the identifier is cheaper than opening the control device and
+     * it does not wake up the card */
+    path = g_strdup_printf (ALSA_PROC_CARD_ID_FILE, num);
+
+    if (g_file_get_contents (path, &id, NULL, NULL) == TRUE) {
+        g_strstrip (id);
+
+        if (*id == '\0')
+            g_clear_pointer (&id, g_free);
+    }
+
+    g_free (path);
+    return id;
+}
+
+static void
+remember_card (AlsaBackend *alsa, const gchar *card, const gchar *id)
+{
+    gint64 num;
+
+    /* Only hardware cards have a number */
+    if (g_str_has_prefix (card, "hw:") == FALSE)
+        return;
+
+    num = g_ascii_strtoll (card + 3, NULL, 10);
+
+    g_hash_table_insert (alsa->priv->cards, GINT_TO_POINTER ((gint) num), g_strdup (id));
+}
+
+static gboolean
+card_has_id (gpointer num G_GNUC_UNUSED, const gchar *card_id, const gchar *id)
+{
+    return strcmp (card_id, id) == 0;
+}
+
 static void
 add_device (AlsaBackend *alsa, AlsaDevice *device)
 {
@@ -375,24 +892,17 @@ add_device (AlsaBackend *alsa, AlsaDevice *device)
                               "closed",
                               G_CALLBACK (remove_device),
                               alsa);
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-removed",
-                              G_CALLBACK (remove_stream),
-                              alsa);
-
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "closed",
-                              G_CALLBACK (free_stream_list),
-                              alsa);
     g_signal_connect_swapped (G_OBJECT (device),
                               "stream-added",
-                              G_CALLBACK (free_stream_list),
+                              G_CALLBACK (add_stream),
                               alsa);
     g_signal_connect_swapped (G_OBJECT (device),
                               "stream-removed",
-                              G_CALLBACK (free_stream_list),
+                              G_CALLBACK (remove_stream),
                               alsa);
 
+    _cafe_mixer_backend_index_device (CAFE_MIXER_BACKEND (alsa),
+                                      CAFE_MIXER_DEVICE (device));
     g_signal_emit_by_name (G_OBJECT (alsa),
                            "device-added",
                            cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
@@ -442,12 +952,14 @@ remove_device_by_list_item (AlsaBackend *alsa, GList *item)
 
     alsa->priv->devices = g_list_delete_link (alsa->priv->devices, item);
 
+    /* Cards of the device are read again if they appear again */
+    g_hash_table_foreach_remove (alsa->priv->cards,
+                                 (GHRFunc) card_has_id,
+                                 ALSA_DEVICE_GET_ID (device));
+
     g_hash_table_remove (alsa->priv->devices_ids,
                          ALSA_DEVICE_GET_ID (device));
 
-    /* The list may have been invalidated by device signals */
-    free_stream_list (alsa);
-
     g_signal_emit_by_name (G_OBJECT (alsa),
                            "device-removed",
                            cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
@@ -455,10 +967,40 @@ remove_device_by_list_item (AlsaBackend *alsa, GList *item)
     g_object_unref (device);
 }
 
+static void
+add_stream (AlsaBackend *alsa, const gchar *name, AlsaDevice *device)
+{
+    CafeMixerStream *stream;
+
+    stream = cafe_mixer_device_get_stream (CAFE_MIXER_DEVICE (device), name);
+    if (G_UNLIKELY (stream == NULL))
+        return;
+
+    /* Appending keeps the streams in the order of devices being loaded, the
+     * list is never longer than two streams per device */
+    alsa->priv->streams =
+        g_list_append (alsa->priv->streams, g_object_ref (stream));
+}
+
 static void
 remove_stream (AlsaBackend *alsa, const gchar *name)
 {
     CafeMixerStream *stream;
+    GList           *list;
+
+    /* The stream is not available from the device anymore at this point,
+     * so it is matched by name */
+    list = alsa->priv->streams;
+    while (list != NULL) {
+        stream = CAFE_MIXER_STREAM (list->data);
+
+        if (strcmp (cafe_mixer_stream_get_name (stream), name) == 0) {
+            alsa->priv->streams = g_list_delete_link (alsa->priv->streams, list);
+            g_object_unref (stream);
+            break;
+        }
+        list = list->next;
+    }
 
     stream = cafe_mixer_backend_get_default_input_stream (CAFE_MIXER_BACKEND (alsa));
 
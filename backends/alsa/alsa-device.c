@@ -23,6 +23,7 @@
 #include <glib-object.h>
 #include <alsa/asoundlib.h>
 #include <libcafemixer/cafemixer.h>
+#include <libcafemixer/cafemixer-private.h>
 
 #include "alsa-compat.h"
 #include "alsa-constants.h"
@@ -50,16 +51,35 @@
 #define ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE(s)                \
         (ALSA_STREAM_CONTROL_GET_SCORE (alsa_stream_get_default_control (ALSA_STREAM (s))))
 
+/* Cards with more mixer elements than this only create the elements of a
+ * stream when the stream is first queried */
+#define LAZY_LOAD_MIN_ELEMENTS  64
+
+/* Loading the global configuration of alsa-lib is not thread-safe and it may
+ * happen whenever a control or a mixer handle is opened, so the handles are
+ * only opened with this lock held. Probing cards in worker threads would
+ * otherwise race on it */
+G_LOCK_DEFINE (alsa_config);
+
+/* Streams a mixer element which has not been created yet belongs to */
+#define PENDING_INPUT           (1 << 0)
+#define PENDING_OUTPUT          (1 << 1)
+
 struct _AlsaDevicePrivate
 {
     snd_mixer_t  *handle;
     GMainContext *context;
-    GMutex        mutex;
-    GCond         cond;
+    GSource      *poll_source;
+    GHashTable   *elements;
+    GHashTable   *changed_elements;
+    gboolean      handling_events;
+    GHashTable   *pending;
+    guint         input_pending;
+    guint         output_pending;
+    guint         loading_depth;
     AlsaStream   *input;
     AlsaStream   *output;
     GList        *streams;
-    gboolean      events_pending;
 };
 
 enum {
@@ -76,7 +96,7 @@ G_DEFINE_TYPE_WITH_PRIVATE (AlsaDevice, alsa_device, CAFE_MIXER_TYPE_DEVICE)
 
 static const GList *      alsa_device_list_streams  (CafeMixerDevice            *mmd);
 
-static void               add_element               (AlsaDevice                 *device,
+static gboolean           add_element               (AlsaDevice                 *device,
                                                      AlsaStream                 *stream,
                                                      AlsaElement                *element);
 
@@ -107,23 +127,53 @@ static void               add_stream_output_toggle  (AlsaDevice
 static void               load_element              (AlsaDevice                 *device,
                                                      snd_mixer_elem_t           *el);
 
-static void               load_elements_by_name     (AlsaDevice                 *device,
+static void               defer_element             (AlsaDevice                 *device,
+                                                     snd_mixer_elem_t           *el);
+
+static void               set_element_pending       (AlsaDevice                 *device,
+                                                     AlsaStream                 *stream,
+                                                     snd_mixer_elem_t           *el,
+                                                     gboolean                    pending);
+static guint              get_pending_flag          (AlsaDevice                 *device,
+                                                     AlsaStream                 *stream);
+static guint *            get_pending_count         (AlsaDevice                 *device,
+                                                     AlsaStream                 *stream);
+static gboolean           is_pending_element        (AlsaDevice                 *device,
+                                                     snd_mixer_elem_t           *el);
+static void               update_pending_element    (AlsaDevice                 *device,
+                                                     snd_mixer_elem_t           *el);
+
+static gboolean           stream_has_elements       (AlsaDevice                 *device,
+                                                     AlsaStream                 *stream);
+static void               remove_stream_if_empty    (AlsaDevice                 *device,
+                                                     AlsaStream                 *stream);
+
+static gboolean           is_default_control        (AlsaStream                 *stream,
                                                      const gchar                *name);
 
 static void               remove_elements_by_name   (AlsaDevice                 *device,
                                                      const gchar                *name);
 
-static void               handle_poll               (AlsaDevice                 *device);
+static gboolean           start_poll                (AlsaDevice                 *device);
+
+static gboolean           poll_source_dispatch      (GSource                    *source,
+                                                     GSourceFunc                 callback,
+                                                     gpointer                    user_data);
 
 static gboolean           handle_process_events     (AlsaDevice                 *device);
 
+static void               load_changed_elements     (AlsaDevice                 *device,
+                                                     snd_mixer_elem_t           *el);
+
 static int                handle_callback           (snd_mixer_t                *handle,
                                                      guint                       mask,
                                                      snd_mixer_elem_t           *el);
 static int                handle_element_callback   (snd_mixer_elem_t           *el,
                                                      guint                       mask);
 
-static void               validate_default_controls (AlsaDevice                 *device);
+static void               validate_default_control  (AlsaStream                 *stream);
+static void               update_default_control    (AlsaStream                 *stream,
+                                                     AlsaStreamControl          *control);
 
 static AlsaStreamControl *get_best_stream_control   (AlsaStream                 *stream);
 
@@ -145,7 +195,11 @@ static void               get_output_control_info   (snd_mixer_elem_t
                                                      CafeMixerStreamControlRole *role,
                                                      gint                       *score);
 
+static CafeMixerDirection get_enum_direction        (snd_mixer_elem_t           *el);
 static CafeMixerDirection get_switch_direction      (snd_mixer_elem_t           *el);
+static void               get_element_directions    (snd_mixer_elem_t           *el,
+                                                     gboolean                   *input,
+                                                     gboolean                   *output);
 static void               get_switch_info           (snd_mixer_elem_t           *el,
                                                      gchar                     **name,
                                                      gchar                     **label,
@@ -155,6 +209,16 @@ static void               close_mixer               (AlsaDevice
 
 static void               free_stream_list          (AlsaDevice                 *device);
 
+/* The source is dispatched whenever any of the mixer descriptors is ready */
+static GSourceFuncs poll_source_funcs = {
+    NULL,
+    NULL,
+    poll_source_dispatch,
+    NULL,
+    NULL,
+    NULL
+};
+
 static void
 alsa_device_class_init (AlsaDeviceClass *klass)
 {
@@ -188,8 +252,20 @@ alsa_device_init (AlsaDevice *device)
 
     device->priv->context = g_main_context_ref_thread_default ();
 
-    g_mutex_init (&device->priv->mutex);
-    g_cond_init (&device->priv->cond);
+    /* Elements of the device by their ALSA mixer element, the elements are
+     * owned by the streams */
+    device->priv->elements = g_hash_table_new_full (g_direct_hash,
+                                                    g_direct_equal,
+                                                    NULL,
+                                                    (GDestroyNotify) g_slist_free);
+
+    /* Mixer elements with a value change during a single pass of event
+     * handling */
+    device->priv->changed_elements = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    /* Mixer elements which have not been created yet and the streams they
+     * belong to */
+    device->priv->pending = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 static void
@@ -214,12 +290,13 @@ alsa_device_finalize (GObject *object)
 
     device = ALSA_DEVICE (object);
 
-    g_mutex_clear (&device->priv->mutex);
-    g_cond_clear (&device->priv->cond);
+    close_mixer (device);
 
-    g_main_context_unref (device->priv->context);
+    g_hash_table_unref (device->priv->elements);
+    g_hash_table_unref (device->priv->changed_elements);
+    g_hash_table_unref (device->priv->pending);
 
-    close_mixer (device);
+    g_main_context_unref (device->priv->context);
 
     G_OBJECT_CLASS (alsa_device_parent_class)->finalize (object);
 }
@@ -262,7 +339,6 @@ alsa_device_open (AlsaDevice *device)
 {
     snd_mixer_t *handle;
     const gchar *name;
-    gint         ret;
 
     g_return_val_if_fail (ALSA_IS_DEVICE (device), FALSE);
     g_return_val_if_fail (device->priv->handle == NULL, FALSE);
@@ -273,20 +349,42 @@ alsa_device_open (AlsaDevice *device)
              name,
              cafe_mixer_device_get_label (CAFE_MIXER_DEVICE (device)));
 
-    /* Open the mixer for the current device */
+    handle = alsa_device_open_mixer (name);
+    if (handle == NULL)
+        return FALSE;
+
+    return alsa_device_open_with_mixer (device, handle);
+}
+
+snd_mixer_t *
+alsa_device_open_mixer (const gchar *name)
+{
+    snd_mixer_t *handle;
+    gint         ret;
+
+    g_return_val_if_fail (name != NULL, NULL);
+
+    /* This function does not touch any device instance, so it may be used
+     * to open the mixer in a worker thread */
     ret = snd_mixer_open (&handle, 0);
     if (ret < 0) {
         g_warning ("Failed to open mixer: %s", snd_strerror (ret));
-        return FALSE;
+        return NULL;
     }
+
+    /* Attaching opens the control handle, loading the elements does not
+     * need the lock and it is the slow part */
+    G_LOCK (alsa_config);
     ret = snd_mixer_attach (handle, name);
+    G_UNLOCK (alsa_config);
+
     if (ret < 0) {
         g_warning ("Failed to attach mixer to %s: %s",
                    name,
                    snd_strerror (ret));
 
         snd_mixer_close (handle);
-        return FALSE;
+        return NULL;
     }
     ret = snd_mixer_selem_register (handle, NULL, NULL);
     if (ret < 0) {
@@ -295,7 +393,7 @@ alsa_device_open (AlsaDevice *device)
                    snd_strerror (ret));
 
         snd_mixer_close (handle);
-        return FALSE;
+        return NULL;
     }
     ret = snd_mixer_load (handle);
     if (ret < 0) {
@@ -304,8 +402,17 @@ alsa_device_open (AlsaDevice *device)
                    snd_strerror (ret));
 
         snd_mixer_close (handle);
-        return FALSE;
+        return NULL;
     }
+    return handle;
+}
+
+gboolean
+alsa_device_open_with_mixer (AlsaDevice *device, snd_mixer_t *handle)
+{
+    g_return_val_if_fail (ALSA_IS_DEVICE (device), FALSE);
+    g_return_val_if_fail (handle != NULL, FALSE);
+    g_return_val_if_fail (device->priv->handle == NULL, FALSE);
 
     device->priv->handle = handle;
     return TRUE;
@@ -331,24 +438,30 @@ alsa_device_close (AlsaDevice *device)
         return;
 
     /* Make each stream remove its controls and switches */
-    if (alsa_stream_has_controls_or_switches (device->priv->input) == TRUE) {
+    if (stream_has_elements (device, device->priv->input) == TRUE) {
         const gchar *name =
             cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (device->priv->input));
 
         alsa_stream_remove_all (device->priv->input);
+        device->priv->input_pending = 0;
         free_stream_list (device);
+        _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                           CAFE_MIXER_STREAM (device->priv->input));
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
                                name);
     }
 
-    if (alsa_stream_has_controls_or_switches (device->priv->output) == TRUE) {
+    if (stream_has_elements (device, device->priv->output) == TRUE) {
         const gchar *name =
             cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (device->priv->output));
 
         alsa_stream_remove_all (device->priv->output);
+        device->priv->output_pending = 0;
         free_stream_list (device);
+        _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                           CAFE_MIXER_STREAM (device->priv->output));
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -363,40 +476,96 @@ alsa_device_close (AlsaDevice *device)
 void
 alsa_device_load (AlsaDevice *device)
 {
-    GThread          *thread;
-    GError           *error = NULL;
     snd_mixer_elem_t *el;
+    gboolean          lazy;
 
     g_return_if_fail (ALSA_IS_DEVICE (device));
     g_return_if_fail (device->priv->handle != NULL);
 
+    /* Creating the elements of large cards is expensive, so only find out
+     * which streams the elements belong to and create them later */
+    lazy = snd_mixer_get_count (device->priv->handle) > LAZY_LOAD_MIN_ELEMENTS;
+
     /* Process the mixer elements */
     el = snd_mixer_first_elem (device->priv->handle);
     while (el != NULL) {
-        load_element (device, el);
+        if (lazy == TRUE)
+            defer_element (device, el);
+        else
+            load_element (device, el);
 
         el = snd_mixer_elem_next (el);
     }
 
-    /* Assign proper default controls */
-    validate_default_controls (device);
-
     /* Set callback for ALSA events */
     snd_mixer_set_callback (device->priv->handle, handle_callback);
     snd_mixer_set_callback_private (device->priv->handle, device);
 
-    /* Start the polling thread */
-    thread = g_thread_try_new ("cafemixer-alsa-poll",
-                               (GThreadFunc) handle_poll,
-                               device,
-                               &error);
-    if (thread == NULL) {
-        /* The error is not treated as fatal, because without the polling
-         * thread we still have most of the functionality */
-        g_warning ("Failed to create poll thread: %s", error->message);
-        g_error_free (error);
-    } else
-        g_thread_unref (thread);
+    /* Watch the mixer descriptors in the main loop. The error is not treated
+     * as fatal, because without the polling we still have most of the
+     * functionality */
+    if (start_poll (device) == FALSE)
+        g_warning ("Failed to watch mixer events for %s",
+                   cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
+}
+
+void
+alsa_device_load_stream (AlsaDevice *device, AlsaStream *stream)
+{
+    AlsaStream       *other_stream;
+    snd_mixer_elem_t *el;
+    guint             flag;
+    gboolean          other_had_elements;
+
+    g_return_if_fail (ALSA_IS_DEVICE (device));
+    g_return_if_fail (ALSA_IS_STREAM (stream));
+
+    flag = get_pending_flag (device, stream);
+    if (flag == 0 || *get_pending_count (device, stream) == 0)
+        return;
+
+    if (stream == device->priv->input)
+        other_stream = device->priv->output;
+    else
+        other_stream = device->priv->input;
+
+    other_had_elements = stream_has_elements (device, other_stream);
+
+    device->priv->loading_depth++;
+
+    /* Load the elements in the mixer order. Signal handlers may query the
+     * stream again while it is being loaded, in which case the nested call
+     * loads the rest of the elements, so it sees all of them */
+    el = snd_mixer_first_elem (device->priv->handle);
+    while (el != NULL) {
+        guint flags = GPOINTER_TO_UINT (g_hash_table_lookup (device->priv->pending, el));
+
+        if (flags & flag) {
+            /* The element is no longer pending once it is being loaded, but
+             * it is counted until it is loaded, so the stream is not
+             * announced again when its first element is added */
+            g_hash_table_remove (device->priv->pending, el);
+
+            /* Loading an element creates it in both streams */
+            load_element (device, el);
+
+            if (flags & PENDING_INPUT)
+                device->priv->input_pending--;
+            if (flags & PENDING_OUTPUT)
+                device->priv->output_pending--;
+        }
+        el = snd_mixer_elem_next (el);
+    }
+
+    /* Some of the elements may have failed to load, leave this to the
+     * outermost call, so the streams are not removed twice */
+    if (--device->priv->loading_depth > 0)
+        return;
+
+    remove_stream_if_empty (device, stream);
+
+    if (other_had_elements == TRUE)
+        remove_stream_if_empty (device, other_stream);
 }
 
 AlsaStream *
@@ -406,7 +575,7 @@ alsa_device_get_input_stream (AlsaDevice *device)
 
     /* Normally controlless streams should not exist, here we simulate the
      * behaviour for the owning instance */
-    if (alsa_stream_has_controls_or_switches (device->priv->input) == TRUE)
+    if (stream_has_elements (device, device->priv->input) == TRUE)
         return device->priv->input;
 
     return NULL;
@@ -419,7 +588,7 @@ alsa_device_get_output_stream (AlsaDevice *device)
 
     /* Normally controlless streams should not exist, here we simulate the
      * behaviour for the owning instance */
-    if (alsa_stream_has_controls_or_switches (device->priv->output) == TRUE)
+    if (stream_has_elements (device, device->priv->output) == TRUE)
         return device->priv->output;
 
     return NULL;
@@ -450,16 +619,17 @@ alsa_device_list_streams (CafeMixerDevice *mmd)
     return device->priv->streams;
 }
 
-static void
+static gboolean
 add_element (AlsaDevice *device, AlsaStream *stream, AlsaElement *element)
 {
     snd_mixer_elem_t *el;
+    GSList           *elements;
     gboolean          add_stream = FALSE;
 
     if (alsa_element_load (element) == FALSE)
-        return;
+        return FALSE;
 
-    if (alsa_stream_has_controls_or_switches (stream) == FALSE)
+    if (stream_has_elements (device, stream) == FALSE)
         add_stream = TRUE;
 
     /* Add element to the stream depending on its type */
@@ -471,7 +641,7 @@ add_element (AlsaDevice *device, AlsaStream *stream, AlsaElement *element)
         alsa_stream_add_toggle (stream, ALSA_TOGGLE (element));
     else {
         g_warn_if_reached ();
-        return;
+        return FALSE;
     }
 
     if (add_stream == TRUE) {
@@ -479,6 +649,8 @@ add_element (AlsaDevice *device, AlsaStream *stream, AlsaElement *element)
             cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (stream));
 
         free_stream_list (device);
+        _cafe_mixer_device_index_stream (CAFE_MIXER_DEVICE (device),
+                                         CAFE_MIXER_STREAM (stream));
 
         /* Pretend the stream has just been created now that we have added
          * the first control */
@@ -492,6 +664,17 @@ add_element (AlsaDevice *device, AlsaStream *stream, AlsaElement *element)
     /* Register to receive callbacks for element changes */
     snd_mixer_elem_set_callback (el, handle_element_callback);
     snd_mixer_elem_set_callback_private (el, device);
+
+    /* A mixer element may be represented by more than one element, e.g. both
+     * an input and an output control */
+    elements = g_hash_table_lookup (device->priv->elements, el);
+    if (elements != NULL)
+        elements = g_slist_append (elements, element);
+    else
+        g_hash_table_insert (device->priv->elements,
+                             el,
+                             g_slist_prepend (NULL, element));
+    return TRUE;
 }
 
 static void
@@ -517,7 +700,8 @@ add_stream_input_control (AlsaDevice *device, snd_mixer_elem_t *el)
 
     alsa_element_set_snd_element (ALSA_ELEMENT (control), el);
 
-    add_element (device, device->priv->input, ALSA_ELEMENT (control));
+    if (add_element (device, device->priv->input, ALSA_ELEMENT (control)) == TRUE)
+        update_default_control (device->priv->input, control);
 
     g_object_unref (control);
 }
@@ -545,7 +729,8 @@ add_stream_output_control (AlsaDevice *device, snd_mixer_elem_t *el)
 
     alsa_element_set_snd_element (ALSA_ELEMENT (control), el);
 
-    add_element (device, device->priv->output, ALSA_ELEMENT (control));
+    if (add_element (device, device->priv->output, ALSA_ELEMENT (control)) == TRUE)
+        update_default_control (device->priv->output, control);
 
     g_object_unref (control);
 }
@@ -698,26 +883,7 @@ load_element (AlsaDevice *device, snd_mixer_elem_t *el)
     gboolean pvolume = FALSE;
 
     if (snd_mixer_selem_is_enumerated (el) == 1) {
-        CafeMixerDirection direction;
-        gboolean           cenum = FALSE;
-        gboolean           penum = FALSE;
-
-#if SND_LIB_VERSION >= ALSA_PACK_VERSION (1, 0, 10)
-        /* The enumeration may have a capture or a playback capability.
-         * If it has either both or none, try to guess the more appropriate
-         * direction. */
-        cenum = snd_mixer_selem_is_enum_capture (el);
-        penum = snd_mixer_selem_is_enum_playback (el);
-#endif
-        if (cenum ^ penum) {
-            if (cenum == TRUE)
-                direction = CAFE_MIXER_DIRECTION_INPUT;
-            else
-                direction = CAFE_MIXER_DIRECTION_OUTPUT;
-        } else
-            direction = get_switch_direction (el);
-
-        if (direction == CAFE_MIXER_DIRECTION_INPUT)
+        if (get_enum_direction (el) == CAFE_MIXER_DIRECTION_INPUT)
             add_stream_input_switch (device, el);
         else
             add_stream_output_switch (device, el);
@@ -746,22 +912,189 @@ load_element (AlsaDevice *device, snd_mixer_elem_t *el)
 }
 
 static void
-load_elements_by_name (AlsaDevice *device, const gchar *name)
+defer_element (AlsaDevice *device, snd_mixer_elem_t *el)
 {
-    alsa_stream_load_elements (device->priv->input, name);
-    alsa_stream_load_elements (device->priv->output, name);
+    gboolean input;
+    gboolean output;
+
+    get_element_directions (el, &input, &output);
+
+    if (input == FALSE && output == FALSE)
+        return;
+
+    if (input == TRUE)
+        set_element_pending (device, device->priv->input, el, TRUE);
+    if (output == TRUE)
+        set_element_pending (device, device->priv->output, el, TRUE);
+
+    /* Removal and capability changes of the element are still tracked */
+    snd_mixer_elem_set_callback (el, handle_element_callback);
+    snd_mixer_elem_set_callback_private (el, device);
+}
+
+static void
+set_element_pending (AlsaDevice       *device,
+                     AlsaStream       *stream,
+                     snd_mixer_elem_t *el,
+                     gboolean          pending)
+{
+    const gchar *name;
+    guint        flags;
+    guint        flag;
+    gboolean     had_elements;
+
+    flags = GPOINTER_TO_UINT (g_hash_table_lookup (device->priv->pending, el));
+    flag  = get_pending_flag (device, stream);
+
+    if (((flags & flag) != 0) == pending)
+        return;
+
+    had_elements = stream_has_elements (device, stream);
+
+    if (pending == TRUE) {
+        g_hash_table_insert (device->priv->pending, el, GUINT_TO_POINTER (flags | flag));
+
+        (*get_pending_count (device, stream))++;
+    } else {
+        if (flags == flag)
+            g_hash_table_remove (device->priv->pending, el);
+        else
+            g_hash_table_insert (device->priv->pending, el, GUINT_TO_POINTER (flags & ~flag));
+
+        (*get_pending_count (device, stream))--;
+    }
+
+    if (pending == FALSE) {
+        if (had_elements == TRUE)
+            remove_stream_if_empty (device, stream);
+        return;
+    }
+    if (had_elements == TRUE)
+        return;
+
+    name = cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (stream));
+
+    free_stream_list (device);
+    _cafe_mixer_device_index_stream (CAFE_MIXER_DEVICE (device),
+                                     CAFE_MIXER_STREAM (stream));
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-added",
+                           name);
+}
+
+static guint
+get_pending_flag (AlsaDevice *device, AlsaStream *stream)
+{
+    if (stream == device->priv->input)
+        return PENDING_INPUT;
+    if (stream == device->priv->output)
+        return PENDING_OUTPUT;
+
+    return 0;
+}
+
+static guint *
+get_pending_count (AlsaDevice *device, AlsaStream *stream)
+{
+    if (stream == device->priv->input)
+        return &device->priv->input_pending;
+    else
+        return &device->priv->output_pending;
+}
+
+static gboolean
+is_pending_element (AlsaDevice *device, snd_mixer_elem_t *el)
+{
+    return g_hash_table_contains (device->priv->pending, el);
+}
+
+/* The capabilities of an element which has not been created yet may have
+ * changed, so it may now belong to different streams */
+static void
+update_pending_element (AlsaDevice *device, snd_mixer_elem_t *el)
+{
+    gboolean input;
+    gboolean output;
+
+    get_element_directions (el, &input, &output);
+
+    /* Add the element to the new streams first, so a stream it stays in is
+     * not removed and added again */
+    if (input == TRUE)
+        set_element_pending (device, device->priv->input, el, TRUE);
+    if (output == TRUE)
+        set_element_pending (device, device->priv->output, el, TRUE);
+    if (input == FALSE)
+        set_element_pending (device, device->priv->input, el, FALSE);
+    if (output == FALSE)
+        set_element_pending (device, device->priv->output, el, FALSE);
+}
+
+static gboolean
+stream_has_elements (AlsaDevice *device, AlsaStream *stream)
+{
+    if (alsa_stream_has_controls_or_switches (stream) == TRUE)
+        return TRUE;
+
+    /* Streams with elements that have not been created yet exist as well */
+    if (*get_pending_count (device, stream) > 0)
+        return TRUE;
+
+    return FALSE;
+}
+
+static void
+remove_stream_if_empty (AlsaDevice *device, AlsaStream *stream)
+{
+    const gchar *name;
+
+    /* Only call this function when the stream had elements before */
+    if (stream_has_elements (device, stream) == TRUE)
+        return;
+
+    name = cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (stream));
+
+    free_stream_list (device);
+    _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                       CAFE_MIXER_STREAM (stream));
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-removed",
+                           name);
+}
+
+static gboolean
+is_default_control (AlsaStream *stream, const gchar *name)
+{
+    AlsaStreamControl *control;
+
+    control = alsa_stream_get_default_control (stream);
+    if (control == NULL)
+        return FALSE;
+
+    return strcmp (cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (control)),
+                   name) == 0;
 }
 
 static void
 remove_elements_by_name (AlsaDevice *device, const gchar *name)
 {
+    gboolean input_default;
+    gboolean output_default;
+
+    /* Removing a control other than the default one cannot make a better
+     * default control available */
+    input_default  = is_default_control (device->priv->input, name);
+    output_default = is_default_control (device->priv->output, name);
+
     if (alsa_stream_remove_elements (device->priv->input, name) == TRUE) {
         /* Removing last stream element "removes" the stream */
-        if (alsa_stream_has_controls_or_switches (device->priv->input) == FALSE) {
+        if (stream_has_elements (device, device->priv->input) == FALSE) {
             const gchar *stream_name =
                 cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (device->priv->input));
 
             free_stream_list (device);
+            _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                               CAFE_MIXER_STREAM (device->priv->input));
             g_signal_emit_by_name (G_OBJECT (device),
                                    "stream-removed",
                                    stream_name);
@@ -770,83 +1103,122 @@ remove_elements_by_name (AlsaDevice *device, const gchar *name)
 
     if (alsa_stream_remove_elements (device->priv->output, name) == TRUE) {
         /* Removing last stream element "removes" the stream */
-        if (alsa_stream_has_controls_or_switches (device->priv->output) == FALSE) {
+        if (stream_has_elements (device, device->priv->output) == FALSE) {
             const gchar *stream_name =
                 cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (device->priv->output));
 
             free_stream_list (device);
+            _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                               CAFE_MIXER_STREAM (device->priv->output));
             g_signal_emit_by_name (G_OBJECT (device),
                                    "stream-removed",
                                    stream_name);
         }
     }
+
+    if (input_default == TRUE)
+        validate_default_control (device->priv->input);
+    if (output_default == TRUE)
+        validate_default_control (device->priv->output);
 }
 
-static void
-handle_poll (AlsaDevice *device)
+static gboolean
+start_poll (AlsaDevice *device)
 {
-    /* This function is called in a worker thread. It is supposed to wait for
-     * ALSA events and call handle_process_events(). Processing the events might
-     * result in emitting the CLOSED signal and unreffing the instance in the
-     * owner, so keep an extra reference during the lifetime of the thread. */
-    g_object_ref (device);
-
-    while (TRUE) {
-        gint ret = snd_mixer_wait (device->priv->handle, -1);
-        if (ret < 0) {
-            if (ret == EINTR)
-                continue;
-            break;
-        }
+    struct pollfd *fds;
+    gint           count;
+    gint           i;
 
-        device->priv->events_pending = TRUE;
+    count = snd_mixer_poll_descriptors_count (device->priv->handle);
+    if (count <= 0)
+        return FALSE;
 
-        /* Process the events in the main thread because most events end up
-         * emitting signals */
-        g_main_context_invoke (device->priv->context,
-                               (GSourceFunc) handle_process_events,
-                               device);
+    fds = g_new (struct pollfd, count);
 
-        g_mutex_lock (&device->priv->mutex);
+    count = snd_mixer_poll_descriptors (device->priv->handle, fds, count);
+    if (count <= 0) {
+        g_free (fds);
+        return FALSE;
+    }
 
-        /* Use a GCond to wait until the events are processed. The processing
-         * function may be called any time later in the main loop and snd_mixer_wait()
-         * returns instantly while there are pending events. Without the wait,
-         * g_main_context_invoke() could be called repeatedly to create idle sources
-         * until the first idle source function is called. */
-        while (device->priv->events_pending == TRUE)
-            g_cond_wait (&device->priv->cond, &device->priv->mutex);
+    device->priv->poll_source = g_source_new (&poll_source_funcs, sizeof (GSource));
 
-        g_mutex_unlock (&device->priv->mutex);
+    for (i = 0; i < count; i++)
+        g_source_add_unix_fd (device->priv->poll_source,
+                              fds[i].fd,
+                              (GIOCondition) fds[i].events);
 
-        /* Exit the thread if the processing function closed the device */
-        if (device->priv->handle == NULL)
-            break;
-    }
+    g_source_set_callback (device->priv->poll_source,
+                           (GSourceFunc) handle_process_events,
+                           device,
+                           NULL);
+    g_source_set_name (device->priv->poll_source, "cafemixer-alsa-poll");
+    g_source_attach (device->priv->poll_source, device->priv->context);
 
-    g_debug ("Terminating poll thread for device %s",
-             cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
+    g_free (fds);
+    return TRUE;
+}
 
-    g_object_unref (device);
+static gboolean
+poll_source_dispatch (GSource    *source G_GNUC_UNUSED,
+                      GSourceFunc callback,
+                      gpointer    user_data)
+{
+    return callback (user_data);
 }
 
 static gboolean
 handle_process_events (AlsaDevice *device)
 {
-    g_mutex_lock (&device->priv->mutex);
+    gboolean ret = G_SOURCE_CONTINUE;
+
+    /* Processing the events might result in emitting the CLOSED signal and
+     * unreffing the instance in the owner */
+    g_object_ref (device);
+
+    /* Value changes are only collected while handling the events, a hardware
+     * volume knob may produce many of them for the same element */
+    device->priv->handling_events = TRUE;
+
+    if (snd_mixer_handle_events (device->priv->handle) < 0) {
+        device->priv->handling_events = FALSE;
+        g_hash_table_remove_all (device->priv->changed_elements);
+
+        /* Closing the device also destroys this source */
+        alsa_device_close (device);
+        ret = G_SOURCE_REMOVE;
+    } else {
+        GHashTableIter iter;
+        gpointer       el;
+
+        device->priv->handling_events = FALSE;
+
+        /* Re-read each changed element once */
+        g_hash_table_iter_init (&iter, device->priv->changed_elements);
+
+        while (g_hash_table_iter_next (&iter, &el, NULL) == TRUE) {
+            g_hash_table_iter_remove (&iter);
 
-    if (device->priv->handle != NULL) {
-        gint ret = snd_mixer_handle_events (device->priv->handle);
-        if (ret < 0)
-            alsa_device_close (device);
+            load_changed_elements (device, el);
+        }
     }
 
-    device->priv->events_pending = FALSE;
+    g_object_unref (device);
+    return ret;
+}
+
+static void
+load_changed_elements (AlsaDevice *device, snd_mixer_elem_t *el)
+{
+    GSList *elements;
 
-    g_cond_signal (&device->priv->cond);
-    g_mutex_unlock (&device->priv->mutex);
+    /* Only re-read the elements representing this mixer element */
+    elements = g_hash_table_lookup (device->priv->elements, el);
+    while (elements != NULL) {
+        alsa_element_load (ALSA_ELEMENT (elements->data));
 
-    return G_SOURCE_REMOVE;
+        elements = elements->next;
+    }
 }
 
 /* ALSA has a per-mixer callback and per-element callback, per-mixer callback
@@ -863,10 +1235,8 @@ handle_callback (snd_mixer_t *handle, guint mask, snd_mixer_elem_t *el)
             return 0;
         }
 
+        /* Default controls are revalidated as the new controls are added */
         load_element (device, el);
-
-        /* Revalidate default controls assignment */
-        validate_default_controls (device);
     }
     return 0;
 }
@@ -883,35 +1253,54 @@ handle_element_callback (snd_mixer_elem_t *el, guint mask)
         return 0;
     }
 
-    name = get_element_name (el);
-
     if (mask == SND_CTL_EVENT_MASK_REMOVE) {
         /* Make sure this function is not called again with the element */
         snd_mixer_elem_set_callback_private (el, NULL);
         snd_mixer_elem_set_callback (el, NULL);
 
+        name = get_element_name (el);
+
+        set_element_pending (device, device->priv->input, el, FALSE);
+        set_element_pending (device, device->priv->output, el, FALSE);
+
+        g_hash_table_remove (device->priv->elements, el);
+        g_hash_table_remove (device->priv->changed_elements, el);
         remove_elements_by_name (device, name);
 
-        /* Revalidate default controls assignment */
-        validate_default_controls (device);
+        g_free (name);
     } else {
+        /* Elements which have not been created yet are read when they are,
+         * only the streams they belong to are kept up to date */
+        if (is_pending_element (device, el) == TRUE) {
+            if (mask & SND_CTL_EVENT_MASK_INFO)
+                update_pending_element (device, el);
+            return 0;
+        }
+
         if (mask & SND_CTL_EVENT_MASK_INFO) {
+            name = get_element_name (el);
+
+            /* The element capabilities may have changed, so create the
+             * elements again */
+            g_hash_table_remove (device->priv->elements, el);
             remove_elements_by_name (device, name);
             load_element (device, el);
 
-            /* Revalidate default controls assignment */
-            validate_default_controls (device);
+            g_free (name);
+        }
+        if (mask & SND_CTL_EVENT_MASK_VALUE) {
+            if (device->priv->handling_events == TRUE)
+                g_hash_table_add (device->priv->changed_elements, el);
+            else
+                load_changed_elements (device, el);
         }
-        if (mask & SND_CTL_EVENT_MASK_VALUE)
-            load_elements_by_name (device, name);
     }
-    g_free (name);
 
     return 0;
 }
 
 static void
-validate_default_controls (AlsaDevice *device)
+validate_default_control (AlsaStream *stream)
 {
     AlsaStreamControl *best;
     gint               best_score;
@@ -932,39 +1321,50 @@ validate_default_controls (AlsaDevice *device)
      *    an element which is reasonably good.
      *
      * In other cases just keep the first control as the default.
+     *
+     * This walks all the stream controls, so it is only used when the default
+     * control is removed, added controls are checked by update_default_control().
      */
-    if (alsa_stream_has_controls (device->priv->input) == TRUE) {
-        best = get_best_stream_control (device->priv->input);
+    if (alsa_stream_has_controls (stream) == FALSE)
+        return;
 
-        best_score    = ALSA_STREAM_CONTROL_GET_SCORE (best);
-        current_score = ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE (device->priv->input);
+    best = get_best_stream_control (stream);
 
-        /* See if the best element would make a good default one */
-        if (best_score > -1) {
-            g_debug ("Found usable default input element %s (score %d)",
-                     cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (best)),
-                     best_score);
+    best_score    = ALSA_STREAM_CONTROL_GET_SCORE (best);
+    current_score = ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE (stream);
 
-            if (current_score == -1 || best_score < current_score)
-                alsa_stream_set_default_control (device->priv->input, best);
-        }
+    /* See if the best element would make a good default one */
+    if (best_score > -1) {
+        g_debug ("Found usable default element %s (score %d)",
+                 cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (best)),
+                 best_score);
+
+        if (current_score == -1 || best_score < current_score)
+            alsa_stream_set_default_control (stream, best);
     }
+}
 
-    if (alsa_stream_has_controls (device->priv->output) == TRUE) {
-        best = get_best_stream_control (device->priv->output);
+static void
+update_default_control (AlsaStream *stream, AlsaStreamControl *control)
+{
+    gint score;
+    gint current_score;
+
+    /* Compare a newly added control with the current default control, which
+     * gives the same result as validate_default_control() called after adding
+     * the control */
+    score = ALSA_STREAM_CONTROL_GET_SCORE (control);
+    if (score == -1)
+        return;
 
-        best_score    = ALSA_STREAM_CONTROL_GET_SCORE (best);
-        current_score = ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE (device->priv->output);
+    current_score = ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE (stream);
 
-        /* See if the best element would make a good default one */
-        if (best_score > -1) {
-            g_debug ("Found usable default output element %s (score %d)",
-                     cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (best)),
-                     best_score);
+    if (current_score == -1 || score < current_score) {
+        g_debug ("Found usable default element %s (score %d)",
+                 cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (control)),
+                 score);
 
-            if (current_score == -1 || best_score < current_score)
-                alsa_stream_set_default_control (device->priv->output, best);
-        }
+        alsa_stream_set_default_control (stream, control);
     }
 }
 
@@ -1062,6 +1462,29 @@ get_output_control_info (snd_mixer_elem_t           *el,
         *score = -1;
 }
 
+static CafeMixerDirection
+get_enum_direction (snd_mixer_elem_t *el)
+{
+    gboolean cenum = FALSE;
+    gboolean penum = FALSE;
+
+#if SND_LIB_VERSION >= ALSA_PACK_VERSION (1, 0, 10)
+    /* The enumeration may have a capture or a playback capability.
+     * If it has either both or none, try to guess the more appropriate
+     * direction. */
+    cenum = snd_mixer_selem_is_enum_capture (el);
+    penum = snd_mixer_selem_is_enum_playback (el);
+#endif
+    if (cenum ^ penum) {
+        if (cenum == TRUE)
+            return CAFE_MIXER_DIRECTION_INPUT;
+        else
+            return CAFE_MIXER_DIRECTION_OUTPUT;
+    }
+
+    return get_switch_direction (el);
+}
+
 static CafeMixerDirection
 get_switch_direction (snd_mixer_elem_t *el)
 {
@@ -1083,6 +1506,43 @@ get_switch_direction (snd_mixer_elem_t *el)
     return direction;
 }
 
+static void
+get_element_directions (snd_mixer_elem_t *el, gboolean *input, gboolean *output)
+{
+    gboolean cvolume = FALSE;
+    gboolean pvolume = FALSE;
+
+    *input  = FALSE;
+    *output = FALSE;
+
+    /* This follows load_element () without creating the elements */
+    if (snd_mixer_selem_is_enumerated (el) == 1) {
+        if (get_enum_direction (el) == CAFE_MIXER_DIRECTION_INPUT)
+            *input = TRUE;
+        else
+            *output = TRUE;
+    }
+
+    if (snd_mixer_selem_has_capture_volume (el) == 1 ||
+        snd_mixer_selem_has_common_volume (el) == 1)
+        cvolume = TRUE;
+    if (snd_mixer_selem_has_playback_volume (el) == 1 ||
+        snd_mixer_selem_has_common_volume (el) == 1)
+        pvolume = TRUE;
+
+    if (cvolume == FALSE && pvolume == FALSE) {
+        if (snd_mixer_selem_has_capture_switch (el) == 1)
+            *input = TRUE;
+        if (snd_mixer_selem_has_playback_switch (el) == 1)
+            *output = TRUE;
+    } else {
+        if (cvolume == TRUE)
+            *input = TRUE;
+        if (pvolume == TRUE)
+            *output = TRUE;
+    }
+}
+
 static void
 get_switch_info (snd_mixer_elem_t          *el,
                  gchar                    **name,
@@ -1129,6 +1589,21 @@ close_mixer (AlsaDevice *device)
      handle = device->priv->handle;
 
      device->priv->handle = NULL;
+
+     g_hash_table_remove_all (device->priv->elements);
+     g_hash_table_remove_all (device->priv->changed_elements);
+
+     g_hash_table_remove_all (device->priv->pending);
+
+     device->priv->input_pending  = 0;
+     device->priv->output_pending = 0;
+
+     /* Stop watching the descriptors before they are closed */
+     if (device->priv->poll_source != NULL) {
+         g_source_destroy (device->priv->poll_source);
+         g_clear_pointer (&device->priv->poll_source, g_source_unref);
+     }
+
      snd_mixer_close (handle);
 }
 
@@ -20,6 +20,7 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <alsa/asoundlib.h>
 #include <libcafemixer/cafemixer.h>
 
 #include "alsa-types.h"
@@ -64,14 +65,23 @@ AlsaDevice *alsa_device_new               (const gchar *name,
                                            const gchar *label);
 
 gboolean    alsa_device_open              (AlsaDevice  *device);
+gboolean    alsa_device_open_with_mixer   (AlsaDevice  *device,
+                                           snd_mixer_t *handle);
 gboolean    alsa_device_is_open           (AlsaDevice  *device);
 void        alsa_device_close             (AlsaDevice  *device);
 
 void        alsa_device_load              (AlsaDevice  *device);
+void        alsa_device_load_stream       (AlsaDevice  *device,
+                                           AlsaStream  *stream);
+
+snd_mixer_t *alsa_device_open_mixer       (const gchar *name);
 
 AlsaStream *alsa_device_get_input_stream  (AlsaDevice  *device);
 AlsaStream *alsa_device_get_output_stream (AlsaDevice  *device);
 
+/* Held while opening ALSA handles, see alsa-device.c */
+G_LOCK_EXTERN (alsa_config);
+
 G_END_DECLS
 
 #endif /* ALSA_DEVICE_H */
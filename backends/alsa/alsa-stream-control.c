@@ -15,6 +15,7 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 #include <alsa/asoundlib.h>
@@ -23,18 +24,28 @@
 #include <libcafemixer/cafemixer-private.h>
 
 #include "alsa-constants.h"
+#include "alsa-device.h"
 #include "alsa-element.h"
 #include "alsa-stream-control.h"
 
+/* Largest volume range for which the decibel values are cached, controls with
+ * wider ranges are converted by alsa-lib on each call */
+#define DECIBEL_TABLE_MAX_SIZE  4096
+
 struct _AlsaStreamControlPrivate
 {
     AlsaControlData   data;
     guint32           channel_mask;
     snd_mixer_elem_t *element;
+    gdouble          *decibels;
+    guint             decibels_min;
+    guint             decibels_max;
 };
 
 static void alsa_element_interface_init    (AlsaElementInterface   *iface);
 
+static void alsa_stream_control_finalize   (GObject                *object);
+
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (AlsaStreamControl, alsa_stream_control,
                                   CAFE_MIXER_TYPE_STREAM_CONTROL,
                                   G_ADD_PRIVATE(AlsaStreamControl)
@@ -100,6 +111,18 @@ static void                     control_data_get_average_front_back      (AlsaCo
 static gfloat                   control_data_get_balance                 (AlsaControlData         *data);
 static gfloat                   control_data_get_fade                    (AlsaControlData         *data);
 
+static void                     set_channel_volumes                      (AlsaStreamControl       *control,
+                                                                          const guint             *volumes);
+
+static void                     update_decibel_table                     (AlsaStreamControl       *control);
+
+static gboolean                 get_decibel_from_volume                  (AlsaStreamControl       *control,
+                                                                          guint                    volume,
+                                                                          gdouble                 *decibel);
+static gboolean                 get_volume_from_decibel                  (AlsaStreamControl       *control,
+                                                                          gdouble                  decibel,
+                                                                          guint                   *volume);
+
 static void
 alsa_element_interface_init (AlsaElementInterface *iface)
 {
@@ -111,8 +134,12 @@ alsa_element_interface_init (AlsaElementInterface *iface)
 static void
 alsa_stream_control_class_init (AlsaStreamControlClass *klass)
 {
+    GObjectClass                *object_class;
     CafeMixerStreamControlClass *control_class;
 
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->finalize = alsa_stream_control_finalize;
+
     control_class = CAFE_MIXER_STREAM_CONTROL_CLASS (klass);
 
     control_class->set_mute             = alsa_stream_control_set_mute;
@@ -141,6 +168,18 @@ alsa_stream_control_init (AlsaStreamControl *control)
     control->priv = alsa_stream_control_get_instance_private (control);
 }
 
+static void
+alsa_stream_control_finalize (GObject *object)
+{
+    AlsaStreamControl *control;
+
+    control = ALSA_STREAM_CONTROL (object);
+
+    g_free (control->priv->decibels);
+
+    G_OBJECT_CLASS (alsa_stream_control_parent_class)->finalize (object);
+}
+
 AlsaControlData *
 alsa_stream_control_get_data (AlsaStreamControl *control)
 {
@@ -192,9 +231,12 @@ alsa_stream_control_set_data (AlsaStreamControl *control, AlsaControlData *data)
         if (data->active == TRUE)
             flags |= CAFE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE;
 
-        if (data->max_decibel > -CAFE_MIXER_INFINITY)
+        if (data->max_decibel > -CAFE_MIXER_INFINITY) {
             flags |= CAFE_MIXER_STREAM_CONTROL_HAS_DECIBEL;
 
+            update_decibel_table (control);
+        }
+
         control->priv->channel_mask = _cafe_mixer_create_channel_mask (data->c, data->channels);
 
         if (data->volume_joined == FALSE) {
@@ -351,18 +393,16 @@ alsa_stream_control_set_volume (CafeMixerStreamControl *mmsc, guint volume)
 static gdouble
 alsa_stream_control_get_decibel (CafeMixerStreamControl *mmsc)
 {
-    AlsaStreamControl      *control;
-    AlsaStreamControlClass *klass;
-    guint                   volume;
-    gdouble                 decibel;
+    AlsaStreamControl *control;
+    guint              volume;
+    gdouble            decibel;
 
     g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (mmsc), -CAFE_MIXER_INFINITY);
 
     control = ALSA_STREAM_CONTROL (mmsc);
-    klass   = ALSA_STREAM_CONTROL_GET_CLASS (control);
     volume  = alsa_stream_control_get_volume (mmsc);
 
-    if (klass->get_decibel_from_volume (control, volume, &decibel) == FALSE)
+    if (get_decibel_from_volume (control, volume, &decibel) == FALSE)
         return -CAFE_MIXER_INFINITY;
 
     return decibel;
@@ -371,16 +411,14 @@ alsa_stream_control_get_decibel (CafeMixerStreamControl *mmsc)
 static gboolean
 alsa_stream_control_set_decibel (CafeMixerStreamControl *mmsc, gdouble decibel)
 {
-    AlsaStreamControl      *control;
-    AlsaStreamControlClass *klass;
-    guint                   volume;
+    AlsaStreamControl *control;
+    guint              volume;
 
     g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = ALSA_STREAM_CONTROL (mmsc);
-    klass   = ALSA_STREAM_CONTROL_GET_CLASS (control);
 
-    if (klass->get_volume_from_decibel (control, decibel, &volume) == FALSE)
+    if (get_volume_from_decibel (control, decibel, &volume) == FALSE)
         return FALSE;
 
     return alsa_stream_control_set_volume (mmsc, volume);
@@ -477,10 +515,9 @@ alsa_stream_control_set_channel_volume (CafeMixerStreamControl *mmsc, guint chan
 static gdouble
 alsa_stream_control_get_channel_decibel (CafeMixerStreamControl *mmsc, guint channel)
 {
-    AlsaStreamControl      *control;
-    AlsaStreamControlClass *klass;
-    guint                   volume;
-    gdouble                 decibel;
+    AlsaStreamControl *control;
+    guint              volume;
+    gdouble            decibel;
 
     g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (mmsc), -CAFE_MIXER_INFINITY);
 
@@ -489,10 +526,9 @@ alsa_stream_control_get_channel_decibel (CafeMixerStreamControl *mmsc, guint cha
     if (channel >= control->priv->data.channels)
         return -CAFE_MIXER_INFINITY;
 
-    klass  = ALSA_STREAM_CONTROL_GET_CLASS (control);
     volume = control->priv->data.v[channel];
 
-    if (klass->get_decibel_from_volume (control, volume, &decibel) == FALSE)
+    if (get_decibel_from_volume (control, volume, &decibel) == FALSE)
         return -CAFE_MIXER_INFINITY;
 
     return decibel;
@@ -503,16 +539,14 @@ alsa_stream_control_set_channel_decibel (CafeMixerStreamControl *mmsc,
                                          guint                   channel,
                                          gdouble                 decibel)
 {
-    AlsaStreamControl      *control;
-    AlsaStreamControlClass *klass;
-    guint                   volume;
+    AlsaStreamControl *control;
+    guint              volume;
 
     g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = ALSA_STREAM_CONTROL (mmsc);
-    klass   = ALSA_STREAM_CONTROL_GET_CLASS (control);
 
-    if (klass->get_volume_from_decibel (control, decibel, &volume) == FALSE)
+    if (get_volume_from_decibel (control, decibel, &volume) == FALSE)
         return FALSE;
 
     return alsa_stream_control_set_channel_volume (mmsc, channel, volume);
@@ -521,22 +555,22 @@ alsa_stream_control_set_channel_decibel (CafeMixerStreamControl *mmsc,
 static gboolean
 alsa_stream_control_set_balance (CafeMixerStreamControl *mmsc, gfloat balance)
 {
-    AlsaStreamControlClass *klass;
-    AlsaStreamControl      *control;
-    AlsaControlData        *data;
-    guint                   left,
-                            right;
-    guint                   nleft,
-                            nright;
-    guint                   max;
-    guint                   channel;
+    AlsaStreamControl *control;
+    AlsaControlData   *data;
+    guint              volumes[CAFE_MIXER_CHANNEL_MAX];
+    guint              left,
+                       right;
+    guint              nleft,
+                       nright;
+    guint              max;
+    guint              channel;
 
     g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = ALSA_STREAM_CONTROL (mmsc);
-    klass   = ALSA_STREAM_CONTROL_GET_CLASS (control);
 
     data = &control->priv->data;
+    memcpy (volumes, data->v, sizeof (volumes));
     control_data_get_average_left_right (data, &left, &right);
 
     max = MAX (left, right);
@@ -553,51 +587,47 @@ alsa_stream_control_set_balance (CafeMixerStreamControl *mmsc, gfloat balance)
         gboolean rc = CAFE_MIXER_IS_RIGHT_CHANNEL (data->c[channel]);
 
         if (lc == TRUE || rc == TRUE) {
-            guint volume;
             if (lc == TRUE) {
                 if (left == 0)
-                    volume = nleft;
+                    volumes[channel] = nleft;
                 else
-                    volume = CLAMP (((guint64) data->v[channel] * (guint64) nleft) / (guint64) left,
-                                    data->min,
-                                    data->max);
+                    volumes[channel] = CLAMP (((guint64) data->v[channel] * (guint64) nleft) / (guint64) left,
+                                              data->min,
+                                              data->max);
             } else {
                 if (right == 0)
-                    volume = nright;
+                    volumes[channel] = nright;
                 else
-                    volume = CLAMP (((guint64) data->v[channel] * (guint64) nright) / (guint64) right,
-                                    data->min,
-                                    data->max);
+                    volumes[channel] = CLAMP (((guint64) data->v[channel] * (guint64) nright) / (guint64) right,
+                                              data->min,
+                                              data->max);
             }
-
-            if (klass->set_channel_volume (control,
-                                           alsa_channel_map_to[data->c[channel]],
-                                           volume) == TRUE)
-                data->v[channel] = volume;
         }
     }
+
+    set_channel_volumes (control, volumes);
     return TRUE;
 }
 
 static gboolean
 alsa_stream_control_set_fade (CafeMixerStreamControl *mmsc, gfloat fade)
 {
-    AlsaStreamControlClass *klass;
-    AlsaStreamControl      *control;
-    AlsaControlData        *data;
-    guint                   front,
-                            back;
-    guint                   nfront,
-                            nback;
-    guint                   max;
-    guint                   channel;
+    AlsaStreamControl *control;
+    AlsaControlData   *data;
+    guint              volumes[CAFE_MIXER_CHANNEL_MAX];
+    guint              front,
+                       back;
+    guint              nfront,
+                       nback;
+    guint              max;
+    guint              channel;
 
     g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = ALSA_STREAM_CONTROL (mmsc);
-    klass   = ALSA_STREAM_CONTROL_GET_CLASS (control);
 
     data = &control->priv->data;
+    memcpy (volumes, data->v, sizeof (volumes));
     control_data_get_average_front_back (data, &front, &back);
 
     max = MAX (front, back);
@@ -614,29 +644,25 @@ alsa_stream_control_set_fade (CafeMixerStreamControl *mmsc, gfloat fade)
         gboolean bc = CAFE_MIXER_IS_BACK_CHANNEL (data->c[channel]);
 
         if (fc == TRUE || bc == TRUE) {
-            guint volume;
             if (fc == TRUE) {
                 if (front == 0)
-                    volume = nfront;
+                    volumes[channel] = nfront;
                 else
-                    volume = CLAMP (((guint64) data->v[channel] * (guint64) nfront) / (guint64) front,
-                                    data->min,
-                                    data->max);
+                    volumes[channel] = CLAMP (((guint64) data->v[channel] * (guint64) nfront) / (guint64) front,
+                                              data->min,
+                                              data->max);
             } else {
                 if (back == 0)
-                    volume = nback;
+                    volumes[channel] = nback;
                 else
-                    volume = CLAMP (((guint64) data->v[channel] * (guint64) nback) / (guint64) back,
-                                    data->min,
-                                    data->max);
+                    volumes[channel] = CLAMP (((guint64) data->v[channel] * (guint64) nback) / (guint64) back,
+                                              data->min,
+                                              data->max);
             }
-
-            if (klass->set_channel_volume (control,
-                                           alsa_channel_map_to[data->c[channel]],
-                                           volume) == TRUE)
-                data->v[channel] = volume;
         }
     }
+
+    set_channel_volumes (control, volumes);
     return TRUE;
 }
 
@@ -749,3 +775,132 @@ control_data_get_fade (AlsaControlData *data)
     else
         return +1.0f - ((gfloat) front / (gfloat) back);
 }
+
+static void
+update_decibel_table (AlsaStreamControl *control)
+{
+    AlsaStreamControlClass *klass;
+    AlsaControlData        *data;
+    guint                   size;
+    guint                   i;
+
+    data = &control->priv->data;
+
+    /* The table only needs to be built once, the range of an element may only
+     * change with an INFO event and the control is created again in that case */
+    if (control->priv->decibels != NULL &&
+        control->priv->decibels_min == data->min &&
+        control->priv->decibels_max == data->max)
+        return;
+
+    g_clear_pointer (&control->priv->decibels, g_free);
+
+    if (data->max < data->min)
+        return;
+
+    size = data->max - data->min + 1;
+    if (size > DECIBEL_TABLE_MAX_SIZE)
+        return;
+
+    klass = ALSA_STREAM_CONTROL_GET_CLASS (control);
+
+    control->priv->decibels = g_new (gdouble, size);
+
+    for (i = 0; i < size; i++) {
+        if (klass->get_decibel_from_volume (control,
+                                            data->min + i,
+                                            &control->priv->decibels[i]) == FALSE) {
+            g_clear_pointer (&control->priv->decibels, g_free);
+            return;
+        }
+    }
+
+    control->priv->decibels_min = data->min;
+    control->priv->decibels_max = data->max;
+}
+
+static gboolean
+get_decibel_from_volume (AlsaStreamControl *control, guint volume, gdouble *decibel)
+{
+    if (control->priv->decibels != NULL) {
+        volume = CLAMP (volume, control->priv->decibels_min, control->priv->decibels_max);
+
+        *decibel = control->priv->decibels[volume - control->priv->decibels_min];
+        return TRUE;
+    }
+
+    return ALSA_STREAM_CONTROL_GET_CLASS (control)->get_decibel_from_volume (control,
+                                                                             volume,
+                                                                             decibel);
+}
+
+static gboolean
+get_volume_from_decibel (AlsaStreamControl *control, gdouble decibel, guint *volume)
+{
+    if (control->priv->decibels != NULL) {
+        guint low  = 0;
+        guint high = control->priv->decibels_max - control->priv->decibels_min;
+        guint last = high;
+
+        /* Find the highest volume not exceeding the given decibel value */
+        while (low < high) {
+            guint mid = low + (high - low + 1) / 2;
+
+            if (control->priv->decibels[mid] <= decibel)
+                low = mid;
+            else
+                high = mid - 1;
+        }
+
+        /* Round to the nearest volume like alsa-lib does when asked for
+         * a volume without a rounding direction */
+        if (low < last &&
+            control->priv->decibels[low] < decibel &&
+            control->priv->decibels[low + 1] - decibel < decibel - control->priv->decibels[low])
+            low++;
+
+        *volume = control->priv->decibels_min + low;
+        return TRUE;
+    }
+
+    return ALSA_STREAM_CONTROL_GET_CLASS (control)->get_volume_from_decibel (control,
+                                                                             decibel,
+                                                                             volume);
+}
+
+static void
+set_channel_volumes (AlsaStreamControl *control, const guint *volumes)
+{
+    AlsaStreamControlClass *klass;
+    AlsaControlData        *data;
+    guint                   channel;
+
+    klass = ALSA_STREAM_CONTROL_GET_CLASS (control);
+    data  = &control->priv->data;
+
+    /* The simple mixer API keeps its cached values in sync with what is
+     * written, so all the writes go through it. Equal volumes of all the
+     * channels are written in a single call, otherwise the changed channels
+     * are set one by one */
+    for (channel = 1; channel < data->channels; channel++)
+        if (volumes[channel] != volumes[0])
+            break;
+
+    if (channel >= data->channels && data->channels > 0 &&
+        klass->set_volume (control, volumes[0]) == TRUE) {
+        for (channel = 0; channel < data->channels; channel++)
+            data->v[channel] = volumes[0];
+        return;
+    }
+
+    for (channel = 0; channel < data->channels; channel++) {
+        if (volumes[channel] == data->v[channel])
+            continue;
+
+        if (klass->set_channel_volume (control,
+                                       alsa_channel_map_to[data->c[channel]],
+                                       volumes[channel]) == TRUE)
+            data->v[channel] = volumes[channel];
+    }
+}
+
@@ -37,13 +37,20 @@ static void alsa_stream_dispose    (GObject         *object);
 
 G_DEFINE_TYPE_WITH_PRIVATE (AlsaStream, alsa_stream, CAFE_MIXER_TYPE_STREAM)
 
-static const GList *alsa_stream_list_controls (CafeMixerStream *mms);
-static const GList *alsa_stream_list_switches (CafeMixerStream *mms);
+static CafeMixerStreamControl *alsa_stream_get_control   (CafeMixerStream *mms,
+                                                          const gchar     *name);
+static CafeMixerStreamSwitch  *alsa_stream_get_switch    (CafeMixerStream *mms,
+                                                          const gchar     *name);
 
-static gint         compare_control_name      (gconstpointer    a,
-                                               gconstpointer    b);
-static gint         compare_switch_name       (gconstpointer    a,
-                                               gconstpointer    b);
+static const GList *           alsa_stream_list_controls (CafeMixerStream *mms);
+static const GList *           alsa_stream_list_switches (CafeMixerStream *mms);
+
+static void                    load_pending_elements     (AlsaStream      *stream);
+
+static CafeMixerStreamControl *find_control              (AlsaStream      *stream,
+                                                          const gchar     *name);
+static CafeMixerStreamSwitch  *find_switch               (AlsaStream      *stream,
+                                                          const gchar     *name);
 
 static void
 alsa_stream_class_init (AlsaStreamClass *klass)
@@ -55,6 +62,8 @@ alsa_stream_class_init (AlsaStreamClass *klass)
     object_class->dispose = alsa_stream_dispose;
 
     stream_class = CAFE_MIXER_STREAM_CLASS (klass);
+    stream_class->get_control   = alsa_stream_get_control;
+    stream_class->get_switch    = alsa_stream_get_switch;
     stream_class->list_controls = alsa_stream_list_controls;
     stream_class->list_switches = alsa_stream_list_switches;
 }
@@ -117,6 +126,9 @@ alsa_stream_add_control (AlsaStream *stream, AlsaStreamControl *control)
     stream->priv->controls =
         g_list_append (stream->priv->controls, g_object_ref (control));
 
+    _cafe_mixer_stream_index_control (CAFE_MIXER_STREAM (stream),
+                                      CAFE_MIXER_STREAM_CONTROL (control));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "control-added",
                            name);
@@ -138,6 +150,9 @@ alsa_stream_add_switch (AlsaStream *stream, AlsaSwitch *swtch)
     stream->priv->switches =
         g_list_append (stream->priv->switches, g_object_ref (swtch));
 
+    _cafe_mixer_stream_index_switch (CAFE_MIXER_STREAM (stream),
+                                     CAFE_MIXER_STREAM_SWITCH (swtch));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
                            name);
@@ -157,6 +172,9 @@ alsa_stream_add_toggle (AlsaStream *stream, AlsaToggle *toggle)
     stream->priv->switches =
         g_list_append (stream->priv->switches, g_object_ref (toggle));
 
+    _cafe_mixer_stream_index_switch (CAFE_MIXER_STREAM (stream),
+                                     CAFE_MIXER_STREAM_SWITCH (toggle));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
                            name);
@@ -201,7 +219,7 @@ alsa_stream_has_default_control (AlsaStream *stream)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (stream), FALSE);
 
-    if (cafe_mixer_stream_get_default_control (CAFE_MIXER_STREAM (stream)) != NULL)
+    if (alsa_stream_get_default_control (stream) != NULL)
         return TRUE;
 
     return FALSE;
@@ -210,13 +228,21 @@ alsa_stream_has_default_control (AlsaStream *stream)
 AlsaStreamControl *
 alsa_stream_get_default_control (AlsaStream *stream)
 {
-    CafeMixerStreamControl *control;
+    CafeMixerStreamControl *control = NULL;
 
     g_return_val_if_fail (ALSA_IS_STREAM (stream), NULL);
 
-    control = cafe_mixer_stream_get_default_control (CAFE_MIXER_STREAM (stream));
-    if (control != NULL)
+    /* Same as cafe_mixer_stream_get_default_control (), but it only looks at
+     * the controls which have already been created */
+    g_object_get (G_OBJECT (stream), "default-control", &control, NULL);
+    if (control != NULL) {
+        /* The stream keeps its own reference */
+        g_object_unref (control);
         return ALSA_STREAM_CONTROL (control);
+    }
+
+    if (stream->priv->controls != NULL)
+        return ALSA_STREAM_CONTROL (stream->priv->controls->data);
 
     return NULL;
 }
@@ -237,38 +263,40 @@ alsa_stream_set_default_control (AlsaStream *stream, AlsaStreamControl *control)
 void
 alsa_stream_load_elements (AlsaStream *stream, const gchar *name)
 {
-    GList *item;
+    CafeMixerStreamControl *control;
+    CafeMixerStreamSwitch  *swtch;
 
     g_return_if_fail (ALSA_IS_STREAM (stream));
     g_return_if_fail (name != NULL);
 
-    item = g_list_find_custom (stream->priv->controls, name, compare_control_name);
-    if (item != NULL)
-        alsa_element_load (ALSA_ELEMENT (item->data));
+    control = find_control (stream, name);
+    if (control != NULL)
+        alsa_element_load (ALSA_ELEMENT (control));
 
-    item = g_list_find_custom (stream->priv->switches, name, compare_switch_name);
-    if (item != NULL)
-        alsa_element_load (ALSA_ELEMENT (item->data));
+    swtch = find_switch (stream, name);
+    if (swtch != NULL)
+        alsa_element_load (ALSA_ELEMENT (swtch));
 }
 
 gboolean
 alsa_stream_remove_elements (AlsaStream *stream, const gchar *name)
 {
-    GList   *item;
-    gboolean removed = FALSE;
+    CafeMixerStreamControl *control;
+    CafeMixerStreamSwitch  *swtch;
+    gboolean                removed = FALSE;
 
     g_return_val_if_fail (ALSA_IS_STREAM (stream), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    item = g_list_find_custom (stream->priv->controls, name, compare_control_name);
-    if (item != NULL) {
-        CafeMixerStreamControl *control = CAFE_MIXER_STREAM_CONTROL (item->data);
-
+    control = find_control (stream, name);
+    if (control != NULL) {
         alsa_element_close (ALSA_ELEMENT (control));
-        stream->priv->controls = g_list_delete_link (stream->priv->controls, item);
+
+        _cafe_mixer_stream_unindex_control (CAFE_MIXER_STREAM (stream), control);
+        stream->priv->controls = g_list_remove (stream->priv->controls, control);
 
         /* Change the default control if we have just removed it */
-        if (control == cafe_mixer_stream_get_default_control (CAFE_MIXER_STREAM (stream))) {
+        if (ALSA_STREAM_CONTROL (control) == alsa_stream_get_default_control (stream)) {
             AlsaStreamControl *first = NULL;
 
             if (stream->priv->controls != NULL)
@@ -285,16 +313,15 @@ alsa_stream_remove_elements (AlsaStream *stream, const gchar *name)
         removed = TRUE;
     }
 
-    item = g_list_find_custom (stream->priv->switches, name, compare_switch_name);
-    if (item != NULL) {
-        CafeMixerSwitch *swtch = CAFE_MIXER_SWITCH (item->data);
-
+    swtch = find_switch (stream, name);
+    if (swtch != NULL) {
         alsa_element_close (ALSA_ELEMENT (swtch));
 
-        stream->priv->switches = g_list_delete_link (stream->priv->switches, item);
+        _cafe_mixer_stream_unindex_switch (CAFE_MIXER_STREAM (stream), swtch);
+        stream->priv->switches = g_list_remove (stream->priv->switches, swtch);
         g_signal_emit_by_name (G_OBJECT (stream),
                                "switch-removed",
-                               cafe_mixer_switch_get_name (swtch));
+                               cafe_mixer_switch_get_name (CAFE_MIXER_SWITCH (swtch)));
 
         g_object_unref (swtch);
         removed = TRUE;
@@ -318,6 +345,8 @@ alsa_stream_remove_all (AlsaStream *stream)
 
         alsa_element_close (ALSA_ELEMENT (control));
 
+        _cafe_mixer_stream_unindex_control (CAFE_MIXER_STREAM (stream), control);
+
         stream->priv->controls = g_list_delete_link (stream->priv->controls, list);
         g_signal_emit_by_name (G_OBJECT (stream),
                                "control-removed",
@@ -338,6 +367,9 @@ alsa_stream_remove_all (AlsaStream *stream)
 
         alsa_element_close (ALSA_ELEMENT (swtch));
 
+        _cafe_mixer_stream_unindex_switch (CAFE_MIXER_STREAM (stream),
+                                           CAFE_MIXER_STREAM_SWITCH (swtch));
+
         stream->priv->switches = g_list_delete_link (stream->priv->switches, list);
         g_signal_emit_by_name (G_OBJECT (stream),
                                "switch-removed",
@@ -348,11 +380,33 @@ alsa_stream_remove_all (AlsaStream *stream)
     }
 }
 
+static CafeMixerStreamControl *
+alsa_stream_get_control (CafeMixerStream *mms, const gchar *name)
+{
+    g_return_val_if_fail (ALSA_IS_STREAM (mms), NULL);
+
+    load_pending_elements (ALSA_STREAM (mms));
+
+    return find_control (ALSA_STREAM (mms), name);
+}
+
+static CafeMixerStreamSwitch *
+alsa_stream_get_switch (CafeMixerStream *mms, const gchar *name)
+{
+    g_return_val_if_fail (ALSA_IS_STREAM (mms), NULL);
+
+    load_pending_elements (ALSA_STREAM (mms));
+
+    return find_switch (ALSA_STREAM (mms), name);
+}
+
 static const GList *
 alsa_stream_list_controls (CafeMixerStream *mms)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (mms), NULL);
 
+    load_pending_elements (ALSA_STREAM (mms));
+
     return ALSA_STREAM (mms)->priv->controls;
 }
 
@@ -361,23 +415,40 @@ alsa_stream_list_switches (CafeMixerStream *mms)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (mms), NULL);
 
+    load_pending_elements (ALSA_STREAM (mms));
+
     return ALSA_STREAM (mms)->priv->switches;
 }
 
-static gint
-compare_control_name (gconstpointer a, gconstpointer b)
+static void
+load_pending_elements (AlsaStream *stream)
+{
+    CafeMixerDevice *device;
+
+    /* The device may postpone creating the elements until they are needed */
+    device = cafe_mixer_stream_get_device (CAFE_MIXER_STREAM (stream));
+    if (G_LIKELY (device != NULL))
+        alsa_device_load_stream (ALSA_DEVICE (device), stream);
+}
+
+static CafeMixerStreamControl *
+find_control (AlsaStream *stream, const gchar *name)
 {
-    CafeMixerStreamControl *control = CAFE_MIXER_STREAM_CONTROL (a);
-    const gchar            *name    = (const gchar *) b;
+    /* The index of the parent class is only used once a control is added,
+     * otherwise it would list the controls and load the pending elements */
+    if (stream->priv->controls == NULL)
+        return NULL;
 
-    return strcmp (cafe_mixer_stream_control_get_name (control), name);
+    return CAFE_MIXER_STREAM_CLASS (alsa_stream_parent_class)->get_control (CAFE_MIXER_STREAM (stream),
+                                                                            name);
 }
 
-static gint
-compare_switch_name (gconstpointer a, gconstpointer b)
+static CafeMixerStreamSwitch *
+find_switch (AlsaStream *stream, const gchar *name)
 {
-    CafeMixerSwitch *swtch = CAFE_MIXER_SWITCH (a);
-    const gchar     *name  = (const gchar *) b;
+    if (stream->priv->switches == NULL)
+        return NULL;
 
-    return strcmp (cafe_mixer_switch_get_name (swtch), name);
+    return CAFE_MIXER_STREAM_CLASS (alsa_stream_parent_class)->get_switch (CAFE_MIXER_STREAM (stream),
+                                                                           name);
 }
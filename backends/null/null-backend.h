@@ -52,6 +52,12 @@ struct _NullBackendClass
 GType                       null_backend_get_type   (void) G_GNUC_CONST;
 
 /* Support function for dynamic loading of the backend module */
+#ifdef BUILTIN_BACKEND
+/* The backend is linked into the library, so the entry points need unique names */
+#define backend_module_init     null_backend_module_init
+#define backend_module_get_info null_backend_module_get_info
+#endif
+
 void                        backend_module_init     (GTypeModule *module);
 const CafeMixerBackendInfo *backend_module_get_info (void);
 
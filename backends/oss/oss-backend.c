@@ -22,6 +22,7 @@
 #include <glib/gstdio.h>
 #include <glib/gi18n.h>
 #include <glib-object.h>
+#include <glib-unix.h>
 
 #include <libcafemixer/cafemixer.h>
 #include <libcafemixer/cafemixer-private.h>
@@ -31,6 +32,10 @@
 #include "oss-device.h"
 #include "oss-stream.h"
 
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+
 #define BACKEND_NAME      "OSS"
 #define BACKEND_PRIORITY  10
 #define BACKEND_FLAGS     CAFE_MIXER_BACKEND_NO_FLAGS
@@ -44,10 +49,15 @@
 
 #define OSS_MAX_DEVICES   32
 
+#define OSS_DEV_DIR           "/dev"
+#define OSS_DEV_MIXER_PREFIX  "mixer"
+
 struct _OssBackendPrivate
 {
     gchar      *default_device;
     GSource    *timeout_source;
+    GSource    *hotplug_source;
+    gint        hotplug_fd;
     GList      *streams;
     GList      *devices;
     GHashTable *devices_paths;
@@ -63,6 +73,16 @@ static void         oss_backend_close            (CafeMixerBackend *backend);
 static const GList *oss_backend_list_devices     (CafeMixerBackend *backend);
 static const GList *oss_backend_list_streams     (CafeMixerBackend *backend);
 
+static gboolean     start_hotplug_watch          (OssBackend       *oss);
+static void         stop_hotplug_watch           (OssBackend       *oss);
+static void         start_poll_timer             (OssBackend       *oss);
+
+#ifdef HAVE_SYS_INOTIFY_H
+static gboolean     read_hotplug_events          (gint              fd,
+                                                  GIOCondition      condition,
+                                                  OssBackend       *oss);
+#endif
+
 static gboolean     read_devices                 (OssBackend       *oss);
 
 static gboolean     read_device                  (OssBackend       *oss,
@@ -149,6 +169,8 @@ oss_backend_init (OssBackend *oss)
 {
     oss->priv = oss_backend_get_instance_private (oss);
 
+    oss->priv->hotplug_fd = -1;
+
     oss->priv->devices_paths = g_hash_table_new_full (g_str_hash,
                                                       g_str_equal,
                                                       g_free,
@@ -191,14 +213,10 @@ oss_backend_open (CafeMixerBackend *backend)
 
     oss = OSS_BACKEND (backend);
 
-    /* Discover added or removed OSS devices every second */
-    oss->priv->timeout_source = g_timeout_source_new_seconds (1);
-    g_source_set_callback (oss->priv->timeout_source,
-                           (GSourceFunc) read_devices,
-                           oss,
-                           NULL);
-    g_source_attach (oss->priv->timeout_source,
-                     g_main_context_get_thread_default ());
+    /* Watch the mixer device nodes to discover added or removed OSS devices,
+     * if this is not possible, scan the device nodes every second instead */
+    if (start_hotplug_watch (oss) == FALSE)
+        start_poll_timer (oss);
 
     /* Read the initial list of devices so we have some starting point, there
      * isn't really a way to detect errors here, failing to add a device may
@@ -218,7 +236,12 @@ oss_backend_close (CafeMixerBackend *backend)
 
     oss = OSS_BACKEND (backend);
 
-    g_source_destroy (oss->priv->timeout_source);
+    stop_hotplug_watch (oss);
+
+    if (oss->priv->timeout_source != NULL) {
+        g_source_destroy (oss->priv->timeout_source);
+        g_clear_pointer (&oss->priv->timeout_source, g_source_unref);
+    }
 
     if (oss->priv->devices != NULL) {
         g_list_free_full (oss->priv->devices, g_object_unref);
@@ -280,6 +303,111 @@ oss_backend_list_streams (CafeMixerBackend *backend)
     return oss->priv->streams;
 }
 
+static gboolean
+start_hotplug_watch (OssBackend *oss G_GNUC_UNUSED)
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    gint fd;
+
+    fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return FALSE;
+
+    /* Access permissions of a new device node are often only set up after
+     * the node is created, so watch for attribute changes as well */
+    if (inotify_add_watch (fd, OSS_DEV_DIR, IN_CREATE | IN_DELETE | IN_ATTRIB) < 0) {
+        g_debug ("Failed to watch %s, polling for OSS device changes", OSS_DEV_DIR);
+
+        close (fd);
+        return FALSE;
+    }
+
+    oss->priv->hotplug_fd = fd;
+    oss->priv->hotplug_source = g_unix_fd_source_new (fd, G_IO_IN);
+
+    g_source_set_callback (oss->priv->hotplug_source,
+                           (GSourceFunc) read_hotplug_events,
+                           oss,
+                           NULL);
+    g_source_attach (oss->priv->hotplug_source,
+                     g_main_context_get_thread_default ());
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+static void
+stop_hotplug_watch (OssBackend *oss)
+{
+    if (oss->priv->hotplug_source != NULL) {
+        g_source_destroy (oss->priv->hotplug_source);
+        g_clear_pointer (&oss->priv->hotplug_source, g_source_unref);
+    }
+
+    if (oss->priv->hotplug_fd != -1) {
+        close (oss->priv->hotplug_fd);
+        oss->priv->hotplug_fd = -1;
+    }
+}
+
+static void
+start_poll_timer (OssBackend *oss)
+{
+    oss->priv->timeout_source = g_timeout_source_new_seconds (1);
+    g_source_set_callback (oss->priv->timeout_source,
+                           (GSourceFunc) read_devices,
+                           oss,
+                           NULL);
+    g_source_attach (oss->priv->timeout_source,
+                     g_main_context_get_thread_default ());
+}
+
+#ifdef HAVE_SYS_INOTIFY_H
+static gboolean
+read_hotplug_events (gint fd, GIOCondition condition, OssBackend *oss)
+{
+    union {
+        struct inotify_event event;
+        gchar                buffer[4096];
+    } events;
+    gssize   len;
+    gboolean changed = FALSE;
+
+    if (condition & (G_IO_ERR | G_IO_HUP)) {
+        /* Should not happen, but keep discovering the devices anyway */
+        g_clear_pointer (&oss->priv->hotplug_source, g_source_unref);
+        stop_hotplug_watch (oss);
+
+        start_poll_timer (oss);
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Drain all the queued events, /dev is busy and most of the events are
+     * unrelated to mixer devices, which only need to be read once */
+    while ((len = read (fd, &events, sizeof (events))) > 0) {
+        gssize offset = 0;
+
+        while (offset < len) {
+            const struct inotify_event *event =
+                (const struct inotify_event *) (events.buffer + offset);
+
+            if ((event->mask & IN_Q_OVERFLOW) ||
+                (event->len > 0 &&
+                 g_str_has_prefix (event->name, OSS_DEV_MIXER_PREFIX) == TRUE))
+                changed = TRUE;
+
+            offset += sizeof (struct inotify_event) + event->len;
+        }
+    }
+
+    if (changed == TRUE)
+        read_devices (oss);
+
+    return G_SOURCE_CONTINUE;
+}
+#endif
+
 static gboolean
 read_devices (OssBackend *oss)
 {
@@ -492,6 +620,8 @@ add_device (OssBackend *oss, OssDevice *device)
                               G_CALLBACK (free_stream_list),
                               oss);
 
+    _cafe_mixer_backend_index_device (CAFE_MIXER_BACKEND (oss),
+                                      CAFE_MIXER_DEVICE (device));
     g_signal_emit_by_name (G_OBJECT (oss),
                            "device-added",
                            cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
@@ -15,6 +15,7 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <errno.h>
 #include <glib.h>
 #include <glib/gi18n.h>
@@ -62,6 +63,7 @@
 #define OSS_POLL_TIMEOUT_NORMAL   500
 #define OSS_POLL_TIMEOUT_RAPID     50
 #define OSS_POLL_TIMEOUT_RESTORE 3000
+#define OSS_POLL_TIMEOUT_MAX     1000
 
 typedef enum {
     OSS_POLL_NORMAL,
@@ -157,19 +159,24 @@ static const gint oss_output_priority[] = {
 
 struct _OssDevicePrivate
 {
-    gint        fd;
-    gchar      *path;
-    gint        devmask;
-    gint        stereodevs;
-    gint        recmask;
-    guint       poll_tag;
-    guint       poll_tag_restore;
-    guint       poll_counter;
-    gboolean    poll_use_counter;
-    OssPollMode poll_mode;
-    GList      *streams;
-    OssStream  *input;
-    OssStream  *output;
+    gint              fd;
+    gchar            *path;
+    gint              devmask;
+    gint              stereodevs;
+    gint              recmask;
+    guint             poll_tag;
+    guint             poll_tag_restore;
+    guint             poll_counter;
+    guint             poll_timeout;
+    gboolean          poll_use_counter;
+    gboolean          poll_loading;
+    OssPollMode       poll_mode;
+    gint              poll_values[SOUND_MIXER_NRDEVICES];
+    gint              poll_recsrc;
+    OssStreamControl *controls[SOUND_MIXER_NRDEVICES];
+    GList            *streams;
+    OssStream        *input;
+    OssStream        *output;
 };
 
 enum {
@@ -189,6 +196,9 @@ static const GList *oss_device_list_streams       (CafeMixerDevice *mmd);
 static gboolean     poll_mixer                    (OssDevice       *device);
 static gboolean     poll_mixer_restore            (OssDevice       *device);
 
+static gboolean     has_listeners                 (OssDevice       *device);
+static gboolean     load_streams                  (OssDevice       *device);
+
 static void         read_mixer_devices            (OssDevice       *device);
 static void         read_mixer_switch             (OssDevice       *device);
 
@@ -231,6 +241,9 @@ static void
 oss_device_init (OssDevice *device)
 {
     device->priv = oss_device_get_instance_private (device);
+
+    device->priv->poll_timeout = OSS_POLL_TIMEOUT_NORMAL;
+    device->priv->poll_recsrc  = -1;
 }
 
 static void
@@ -354,6 +367,10 @@ oss_device_close (OssDevice *device)
     if (device->priv->fd == -1)
         return;
 
+    /* The controls are owned by the streams */
+    memset (device->priv->controls, 0, sizeof (device->priv->controls));
+    device->priv->poll_recsrc = -1;
+
     /* Make each stream remove its controls and switch */
     if (device->priv->input != NULL) {
         const gchar *name =
@@ -361,6 +378,8 @@ oss_device_close (OssDevice *device)
 
         oss_stream_remove_all (device->priv->input);
         free_stream_list (device);
+        _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                           CAFE_MIXER_STREAM (device->priv->input));
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -375,6 +394,8 @@ oss_device_close (OssDevice *device)
 
         oss_stream_remove_all (device->priv->output);
         free_stream_list (device);
+        _cafe_mixer_device_unindex_stream (CAFE_MIXER_DEVICE (device),
+                                           CAFE_MIXER_STREAM (device->priv->output));
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -383,11 +404,15 @@ oss_device_close (OssDevice *device)
         g_clear_object (&device->priv->output);
     }
 
-    if (device->priv->poll_tag != 0)
+    if (device->priv->poll_tag != 0) {
         g_source_remove (device->priv->poll_tag);
+        device->priv->poll_tag = 0;
+    }
 
-    if (device->priv->poll_tag_restore != 0)
+    if (device->priv->poll_tag_restore != 0) {
         g_source_remove (device->priv->poll_tag_restore);
+        device->priv->poll_tag_restore = 0;
+    }
 
     close (device->priv->fd);
     device->priv->fd = -1;
@@ -490,8 +515,39 @@ oss_device_load (OssDevice *device)
      * This is not used on systems which don't support the modify_counter
      * field, because there is no way to find out whether anything has
      * changed and therefore when to start the rapid polling.
+     *
+     * The interval grows a little while nothing changes and polling stops
+     * while nobody is listening to the controls, see poll_mixer ().
+     *
+     * Listing the stream controls above may have already started polling.
      */
-    device->priv->poll_tag = create_poll_source (device, OSS_POLL_NORMAL);
+    if (device->priv->poll_tag == 0)
+        device->priv->poll_tag = create_poll_source (device, OSS_POLL_NORMAL);
+}
+
+void
+oss_device_resume_polling (OssDevice *device)
+{
+    g_return_if_fail (OSS_IS_DEVICE (device));
+
+    /* Changes found while polling reset the interval anyway, the current
+     * source must not be replaced from a signal handler */
+    if (device->priv->fd == -1 || device->priv->poll_loading == TRUE)
+        return;
+
+    /* Already polling at the shortest normal or the rapid interval */
+    if (device->priv->poll_tag != 0 &&
+        (device->priv->poll_mode == OSS_POLL_RAPID ||
+         device->priv->poll_timeout == OSS_POLL_TIMEOUT_NORMAL))
+        return;
+
+    g_debug ("Resuming polling of device %s", device->priv->path);
+
+    if (device->priv->poll_tag != 0)
+        g_source_remove (device->priv->poll_tag);
+
+    device->priv->poll_timeout = OSS_POLL_TIMEOUT_NORMAL;
+    device->priv->poll_tag     = create_poll_source (device, OSS_POLL_NORMAL);
 }
 
 const gchar *
@@ -594,6 +650,8 @@ read_mixer_devices (OssDevice *device)
                 cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (stream));
 
             free_stream_list (device);
+            _cafe_mixer_device_index_stream (CAFE_MIXER_DEVICE (device),
+                                             CAFE_MIXER_STREAM (stream));
 
             /* Pretend the stream has just been created now that we are adding
              * the first control */
@@ -609,6 +667,11 @@ read_mixer_devices (OssDevice *device)
         oss_stream_add_control (stream, control);
         oss_stream_control_load (control);
 
+        /* The stream keeps the control alive until the device is closed,
+         * the value is cached during the first poll */
+        device->priv->controls[i]    = control;
+        device->priv->poll_values[i] = -1;
+
         g_object_unref (control);
     }
 }
@@ -646,10 +709,25 @@ static gboolean
 poll_mixer (OssDevice *device)
 {
     gboolean load = TRUE;
+    gboolean changed = FALSE;
 
     if (G_UNLIKELY (device->priv->fd == -1))
         return G_SOURCE_REMOVE;
 
+    /* Changes would not be noticed by anyone, stop polling until a control
+     * or a switch of the device is looked up, listed or written to again */
+    if (has_listeners (device) == FALSE) {
+        g_debug ("Pausing polling of device %s", device->priv->path);
+
+        if (device->priv->poll_tag_restore != 0) {
+            g_source_remove (device->priv->poll_tag_restore);
+            device->priv->poll_tag_restore = 0;
+        }
+        device->priv->poll_tag  = 0;
+        device->priv->poll_mode = OSS_POLL_NORMAL;
+        return G_SOURCE_REMOVE;
+    }
+
 #ifdef SOUND_MIXER_INFO
     if (device->priv->poll_use_counter == TRUE) {
         gint   ret;
@@ -681,13 +759,24 @@ poll_mixer (OssDevice *device)
 #endif
 
     if (load == TRUE) {
-        if (device->priv->input != NULL)
-            oss_stream_load (device->priv->input);
-        if (device->priv->output != NULL)
-            oss_stream_load (device->priv->output);
+        device->priv->poll_loading = TRUE;
+        changed = load_streams (device);
+        device->priv->poll_loading = FALSE;
+
+        /* The device might have been closed by a signal handler */
+        if (G_UNLIKELY (device->priv->fd == -1))
+            return G_SOURCE_REMOVE;
+
+        /* The counter may increase even when the values stay the same */
+        if (device->priv->poll_use_counter == TRUE)
+            changed = TRUE;
+    }
 
-        if (device->priv->poll_use_counter == TRUE &&
-            device->priv->poll_mode == OSS_POLL_NORMAL) {
+    if (device->priv->poll_mode == OSS_POLL_RAPID)
+        return G_SOURCE_CONTINUE;
+
+    if (changed == TRUE) {
+        if (device->priv->poll_use_counter == TRUE) {
             /* Create a new rapid source */
             device->priv->poll_tag = create_poll_source (device, OSS_POLL_RAPID);
 
@@ -698,8 +787,23 @@ poll_mixer (OssDevice *device)
             device->priv->poll_mode = OSS_POLL_RAPID;
             return G_SOURCE_REMOVE;
         }
+
+        if (device->priv->poll_timeout == OSS_POLL_TIMEOUT_NORMAL)
+            return G_SOURCE_CONTINUE;
+
+        device->priv->poll_timeout = OSS_POLL_TIMEOUT_NORMAL;
+    } else {
+        /* Back off while nothing changes, but not much beyond the normal
+         * interval, so external changes still show up quickly */
+        if (device->priv->poll_timeout >= OSS_POLL_TIMEOUT_MAX)
+            return G_SOURCE_CONTINUE;
+
+        device->priv->poll_timeout = MIN (device->priv->poll_timeout * 2,
+                                          OSS_POLL_TIMEOUT_MAX);
     }
-    return G_SOURCE_CONTINUE;
+
+    device->priv->poll_tag = create_poll_source (device, OSS_POLL_NORMAL);
+    return G_SOURCE_REMOVE;
 }
 
 static gboolean
@@ -709,8 +813,9 @@ poll_mixer_restore (OssDevice *device)
         /* Remove the current rapid source */
         g_source_remove (device->priv->poll_tag);
 
-        device->priv->poll_tag  = create_poll_source (device, OSS_POLL_NORMAL);
-        device->priv->poll_mode = OSS_POLL_NORMAL;
+        device->priv->poll_timeout = OSS_POLL_TIMEOUT_NORMAL;
+        device->priv->poll_tag     = create_poll_source (device, OSS_POLL_NORMAL);
+        device->priv->poll_mode    = OSS_POLL_NORMAL;
     }
 
     /* Remove the tag for this function as it is only called once, the tag
@@ -720,6 +825,61 @@ poll_mixer_restore (OssDevice *device)
     return G_SOURCE_REMOVE;
 }
 
+static gboolean
+has_listeners (OssDevice *device)
+{
+    if (device->priv->input != NULL &&
+        oss_stream_has_listeners (device->priv->input) == TRUE)
+        return TRUE;
+    if (device->priv->output != NULL &&
+        oss_stream_has_listeners (device->priv->output) == TRUE)
+        return TRUE;
+
+    return FALSE;
+}
+
+static gboolean
+load_streams (OssDevice *device)
+{
+    gboolean changed = FALSE;
+    gint     value;
+    guint    i;
+
+    /* Read the packed values of all the controls in one pass and only let
+     * the controls whose value has changed since the last poll decode it,
+     * this keeps the balance update and notifications out of the loop */
+    for (i = 0; i < OSS_N_DEVICES; i++) {
+        if (device->priv->controls[i] == NULL)
+            continue;
+
+        if (ioctl (device->priv->fd, MIXER_READ (i), &value) == -1)
+            continue;
+
+        value &= 0xFFFF;
+        if (value == device->priv->poll_values[i])
+            continue;
+
+        device->priv->poll_values[i] = value;
+
+        if (oss_stream_control_update (device->priv->controls[i], value) == TRUE)
+            changed = TRUE;
+    }
+
+    if (device->priv->input == NULL || device->priv->recmask == 0)
+        return changed;
+
+    if (ioctl (device->priv->fd, MIXER_READ (SOUND_MIXER_RECSRC), &value) == -1)
+        return changed;
+
+    if (value != device->priv->poll_recsrc) {
+        device->priv->poll_recsrc = value;
+
+        if (oss_stream_load_switch (device->priv->input) == TRUE)
+            changed = TRUE;
+    }
+    return changed;
+}
+
 static guint
 create_poll_source (OssDevice *device, OssPollMode mode)
 {
@@ -729,7 +889,7 @@ create_poll_source (OssDevice *device, OssPollMode mode)
 
     switch (mode) {
     case OSS_POLL_NORMAL:
-        timeout = OSS_POLL_TIMEOUT_NORMAL;
+        timeout = device->priv->poll_timeout;
         break;
     case OSS_POLL_RAPID:
         timeout = OSS_POLL_TIMEOUT_RAPID;
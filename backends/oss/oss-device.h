@@ -70,6 +70,7 @@ gboolean     oss_device_is_open           (OssDevice   *device);
 void         oss_device_close             (OssDevice   *device);
 
 void         oss_device_load              (OssDevice   *device);
+void         oss_device_resume_polling    (OssDevice   *device);
 
 const gchar *oss_device_get_path          (OssDevice   *device);
 
@@ -77,7 +77,7 @@ static guint                    oss_stream_control_get_max_volume       (CafeMix
 static guint                    oss_stream_control_get_normal_volume    (CafeMixerStreamControl  *mmsc);
 static guint                    oss_stream_control_get_base_volume      (CafeMixerStreamControl  *mmsc);
 
-static void                     store_volume                            (OssStreamControl        *control,
+static gboolean                 store_volume                            (OssStreamControl        *control,
                                                                          gint                     volume);
 
 static void                     update_balance                          (OssStreamControl        *control);
@@ -180,21 +180,29 @@ oss_stream_control_get_devnum (OssStreamControl *control)
     return control->priv->devnum;
 }
 
-void
+gboolean
 oss_stream_control_load (OssStreamControl *control)
 {
     gint v, ret;
 
-    g_return_if_fail (OSS_IS_STREAM_CONTROL (control));
+    g_return_val_if_fail (OSS_IS_STREAM_CONTROL (control), FALSE);
 
     if (G_UNLIKELY (control->priv->fd == -1))
-        return;
+        return FALSE;
 
     ret = ioctl (control->priv->fd, MIXER_READ (control->priv->devnum), &v);
     if (ret == -1)
-        return;
+        return FALSE;
+
+    return store_volume (control, v);
+}
+
+gboolean
+oss_stream_control_update (OssStreamControl *control, gint volume)
+{
+    g_return_val_if_fail (OSS_IS_STREAM_CONTROL (control), FALSE);
 
-    store_volume (control, v);
+    return store_volume (control, volume);
 }
 
 void
@@ -388,12 +396,12 @@ oss_stream_control_get_base_volume (CafeMixerStreamControl *mmsc)
     return 100;
 }
 
-static void
+static gboolean
 store_volume (OssStreamControl *control, gint volume)
 {
     if (control->priv->stereo == TRUE) {
         if (volume == OSS_VOLUME_JOIN_ARRAY (control->priv->volume))
-            return;
+            return FALSE;
 
         control->priv->volume[LEFT_CHANNEL]  = OSS_VOLUME_TAKE_LEFT (volume);
         control->priv->volume[RIGHT_CHANNEL] = OSS_VOLUME_TAKE_RIGHT (volume);
@@ -409,12 +417,13 @@ store_volume (OssStreamControl *control, gint volume)
     } else {
         volume = OSS_VOLUME_TAKE_LEFT (volume);
         if (volume == control->priv->volume[LEFT_CHANNEL])
-            return;
+            return FALSE;
 
         control->priv->volume[LEFT_CHANNEL] = volume;
 
         g_object_notify (G_OBJECT (control), "volume");
     }
+    return TRUE;
 }
 
 static void
@@ -441,7 +450,8 @@ update_balance (OssStreamControl *control)
 static gboolean
 write_and_store_volume (OssStreamControl *control, gint volume)
 {
-    gint ret;
+    CafeMixerStream *stream;
+    gint             ret;
 
     /* Nothing to do? */
     if (volume == OSS_VOLUME_JOIN_ARRAY (control->priv->volume))
@@ -453,5 +463,10 @@ write_and_store_volume (OssStreamControl *control, gint volume)
         return FALSE;
 
     store_volume (control, volume & 0xFFFF);
+
+    /* Someone is interested in the control, make sure polling is running */
+    stream = cafe_mixer_stream_control_get_stream (CAFE_MIXER_STREAM_CONTROL (control));
+    if (G_LIKELY (stream != NULL))
+        oss_stream_resume_polling (OSS_STREAM (stream));
     return TRUE;
 }
@@ -67,7 +67,9 @@ OssStreamControl *oss_stream_control_new        (const gchar               *name
 
 gint              oss_stream_control_get_devnum (OssStreamControl          *control);
 
-void              oss_stream_control_load       (OssStreamControl          *control);
+gboolean          oss_stream_control_load       (OssStreamControl          *control);
+gboolean          oss_stream_control_update     (OssStreamControl          *control,
+                                                 gint                       volume);
 void              oss_stream_control_close      (OssStreamControl          *control);
 
 G_END_DECLS
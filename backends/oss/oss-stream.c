@@ -39,8 +39,12 @@ static void oss_stream_dispose    (GObject        *object);
 
 G_DEFINE_TYPE_WITH_PRIVATE (OssStream, oss_stream, CAFE_MIXER_TYPE_STREAM)
 
-static const GList *oss_stream_list_controls (CafeMixerStream *mms);
-static const GList *oss_stream_list_switches (CafeMixerStream *mms);
+static CafeMixerStreamControl *oss_stream_get_control    (CafeMixerStream *mms,
+                                                          const gchar     *name);
+static CafeMixerStreamSwitch * oss_stream_get_switch     (CafeMixerStream *mms,
+                                                          const gchar     *name);
+static const GList *           oss_stream_list_controls  (CafeMixerStream *mms);
+static const GList *           oss_stream_list_switches  (CafeMixerStream *mms);
 
 static void
 oss_stream_class_init (OssStreamClass *klass)
@@ -52,6 +56,8 @@ oss_stream_class_init (OssStreamClass *klass)
     object_class->dispose = oss_stream_dispose;
 
     stream_class = CAFE_MIXER_STREAM_CLASS (klass);
+    stream_class->get_control   = oss_stream_get_control;
+    stream_class->get_switch    = oss_stream_get_switch;
     stream_class->list_controls = oss_stream_list_controls;
     stream_class->list_switches = oss_stream_list_switches;
 }
@@ -116,28 +122,34 @@ oss_stream_add_control (OssStream *stream, OssStreamControl *control)
     stream->priv->controls =
         g_list_append (stream->priv->controls, g_object_ref (control));
 
+    _cafe_mixer_stream_index_control (CAFE_MIXER_STREAM (stream),
+                                      CAFE_MIXER_STREAM_CONTROL (control));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "control-added",
                            name);
 }
 
-void
-oss_stream_load (OssStream *stream)
+gboolean
+oss_stream_load_switch (OssStream *stream)
 {
-    GList *list;
+    CafeMixerSwitch       *swtch;
+    CafeMixerSwitchOption *active;
 
-    g_return_if_fail (OSS_IS_STREAM (stream));
+    g_return_val_if_fail (OSS_IS_STREAM (stream), FALSE);
 
-    list = stream->priv->controls;
-    while (list != NULL) {
-        OssStreamControl *control = OSS_STREAM_CONTROL (list->data);
+    if (stream->priv->swtch == NULL)
+        return FALSE;
 
-        oss_stream_control_load (control);
-        list = list->next;
-    }
+    swtch  = CAFE_MIXER_SWITCH (stream->priv->swtch);
+    active = cafe_mixer_switch_get_active_option (swtch);
+
+    oss_switch_load (stream->priv->swtch);
 
-    if (stream->priv->swtch != NULL)
-        oss_switch_load (stream->priv->swtch);
+    if (cafe_mixer_switch_get_active_option (swtch) != active)
+        return TRUE;
+
+    return FALSE;
 }
 
 gboolean
@@ -151,6 +163,40 @@ oss_stream_has_controls (OssStream *stream)
     return FALSE;
 }
 
+gboolean
+oss_stream_has_listeners (OssStream *stream)
+{
+    GList *list;
+    guint  signal_id;
+
+    g_return_val_if_fail (OSS_IS_STREAM (stream), FALSE);
+
+    /* Polling only results in property notifications on the controls and
+     * the switch, so these are the handlers which matter regardless of the
+     * property they are connected to */
+    signal_id = g_signal_lookup ("notify", G_TYPE_OBJECT);
+
+    list = stream->priv->controls;
+    while (list != NULL) {
+        if (g_signal_handler_find (list->data,
+                                   G_SIGNAL_MATCH_ID,
+                                   signal_id,
+                                   0, NULL, NULL, NULL) != 0)
+            return TRUE;
+
+        list = list->next;
+    }
+
+    if (stream->priv->swtch != NULL &&
+        g_signal_handler_find (stream->priv->swtch,
+                               G_SIGNAL_MATCH_ID,
+                               signal_id,
+                               0, NULL, NULL, NULL) != 0)
+        return TRUE;
+
+    return FALSE;
+}
+
 gboolean
 oss_stream_has_default_control (OssStream *stream)
 {
@@ -215,6 +261,10 @@ oss_stream_set_switch_data (OssStream *stream, gint fd, GList *options)
     oss_switch_load (stream->priv->swtch);
 
     stream->priv->switches = g_list_prepend (NULL, g_object_ref (stream->priv->swtch));
+
+    _cafe_mixer_stream_index_switch (CAFE_MIXER_STREAM (stream),
+                                     CAFE_MIXER_STREAM_SWITCH (stream->priv->swtch));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
                            OSS_STREAM_SWITCH_NAME);
@@ -234,6 +284,8 @@ oss_stream_remove_all (OssStream *stream)
 
         oss_stream_control_close (OSS_STREAM_CONTROL (control));
 
+        _cafe_mixer_stream_unindex_control (CAFE_MIXER_STREAM (stream), control);
+
         stream->priv->controls = g_list_delete_link (stream->priv->controls, list);
         g_signal_emit_by_name (G_OBJECT (stream),
                                "control-removed",
@@ -249,6 +301,9 @@ oss_stream_remove_all (OssStream *stream)
     if (stream->priv->swtch != NULL) {
         oss_switch_close (stream->priv->swtch);
 
+        _cafe_mixer_stream_unindex_switch (CAFE_MIXER_STREAM (stream),
+                                           CAFE_MIXER_STREAM_SWITCH (stream->priv->swtch));
+
         g_list_free_full (stream->priv->switches, g_object_unref);
         stream->priv->switches = NULL;
 
@@ -260,11 +315,50 @@ oss_stream_remove_all (OssStream *stream)
     }
 }
 
+void
+oss_stream_resume_polling (OssStream *stream)
+{
+    CafeMixerDevice *device;
+
+    g_return_if_fail (OSS_IS_STREAM (stream));
+
+    device = cafe_mixer_stream_get_device (CAFE_MIXER_STREAM (stream));
+    if (G_LIKELY (device != NULL))
+        oss_device_resume_polling (OSS_DEVICE (device));
+}
+
+static CafeMixerStreamControl *
+oss_stream_get_control (CafeMixerStream *mms, const gchar *name)
+{
+    g_return_val_if_fail (OSS_IS_STREAM (mms), NULL);
+
+    /* Looking up a control by name usually comes before connecting to its
+     * signals, the lookup may not list the controls when the name index
+     * is used */
+    oss_stream_resume_polling (OSS_STREAM (mms));
+
+    return CAFE_MIXER_STREAM_CLASS (oss_stream_parent_class)->get_control (mms, name);
+}
+
+static CafeMixerStreamSwitch *
+oss_stream_get_switch (CafeMixerStream *mms, const gchar *name)
+{
+    g_return_val_if_fail (OSS_IS_STREAM (mms), NULL);
+
+    oss_stream_resume_polling (OSS_STREAM (mms));
+
+    return CAFE_MIXER_STREAM_CLASS (oss_stream_parent_class)->get_switch (mms, name);
+}
+
 static const GList *
 oss_stream_list_controls (CafeMixerStream *mms)
 {
     g_return_val_if_fail (OSS_IS_STREAM (mms), NULL);
 
+    /* Listing the controls is what often comes before connecting to their
+     * signals, so use it as a hint that polling should speed up again */
+    oss_stream_resume_polling (OSS_STREAM (mms));
+
     return OSS_STREAM (mms)->priv->controls;
 }
 
@@ -273,5 +367,7 @@ oss_stream_list_switches (CafeMixerStream *mms)
 {
     g_return_val_if_fail (OSS_IS_STREAM (mms), NULL);
 
+    oss_stream_resume_polling (OSS_STREAM (mms));
+
     return OSS_STREAM (mms)->priv->switches;
 }
@@ -64,9 +64,10 @@ OssStream *       oss_stream_new                 (const gchar       *name,
 void              oss_stream_add_control         (OssStream         *stream,
                                                   OssStreamControl  *control);
 
-void              oss_stream_load                (OssStream         *stream);
+gboolean          oss_stream_load_switch         (OssStream         *stream);
 
 gboolean          oss_stream_has_controls        (OssStream         *stream);
+gboolean          oss_stream_has_listeners       (OssStream         *stream);
 gboolean          oss_stream_has_default_control (OssStream         *stream);
 
 OssStreamControl *oss_stream_get_default_control (OssStream         *stream);
@@ -79,6 +80,8 @@ void              oss_stream_set_switch_data     (OssStream         *stream,
 
 void              oss_stream_remove_all          (OssStream         *stream);
 
+void              oss_stream_resume_polling      (OssStream         *stream);
+
 G_END_DECLS
 
 #endif /* OSS_STREAM_H */
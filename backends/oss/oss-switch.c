@@ -211,9 +211,10 @@ oss_switch_close (OssSwitch *swtch)
 static gboolean
 oss_switch_set_active_option (CafeMixerSwitch *mms, CafeMixerSwitchOption *mmso)
 {
-    OssSwitch *swtch;
-    gint       ret;
-    gint       recsrc;
+    CafeMixerStream *stream;
+    OssSwitch       *swtch;
+    gint             ret;
+    gint             recsrc;
 
     g_return_val_if_fail (OSS_IS_SWITCH (mms), FALSE);
     g_return_val_if_fail (OSS_IS_SWITCH_OPTION (mmso), FALSE);
@@ -229,6 +230,10 @@ oss_switch_set_active_option (CafeMixerSwitch *mms, CafeMixerSwitchOption *mmso)
     if (ret == -1)
         return FALSE;
 
+    /* Someone is interested in the switch, make sure polling is running */
+    stream = cafe_mixer_stream_switch_get_stream (CAFE_MIXER_STREAM_SWITCH (mms));
+    if (G_LIKELY (stream != NULL))
+        oss_stream_resume_polling (OSS_STREAM (stream));
     return TRUE;
 }
 
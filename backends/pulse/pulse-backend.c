@@ -56,6 +56,7 @@ struct _PulseBackendPrivate
     GList            *devices_list;
     GList            *streams_list;
     GList            *ext_streams_list;
+    GHashTable       *list_links;
     CafeMixerAppInfo *app_info;
     gchar            *server_address;
     PulseConnection  *connection;
@@ -138,6 +139,9 @@ static gboolean         pulse_backend_set_default_input_stream  (CafeMixerBacken
 static gboolean         pulse_backend_set_default_output_stream (CafeMixerBackend *backend,
                                                                  CafeMixerStream  *stream);
 
+static void             pulse_backend_begin_changes             (CafeMixerBackend *backend);
+static void             pulse_backend_commit_changes            (CafeMixerBackend *backend);
+
 static void             on_connection_state_notify          (PulseConnection                  *connection,
                                                              GParamSpec                       *pspec,
                                                              PulseBackend                     *pulse);
@@ -198,6 +202,13 @@ static void             remove_source_output                (PulseBackend
                                                              PulseSource                      *source,
                                                              guint                             index);
 
+static void             list_add_object                     (PulseBackend                     *pulse,
+                                                             GList                           **list,
+                                                             gpointer                          object);
+static void             list_remove_object                  (PulseBackend                     *pulse,
+                                                             GList                           **list,
+                                                             gpointer                          object);
+
 static void             free_list_devices                   (PulseBackend                     *pulse);
 static void             free_list_streams                   (PulseBackend                     *pulse);
 static void             free_list_ext_streams               (PulseBackend                     *pulse);
@@ -245,6 +256,8 @@ pulse_backend_class_init (PulseBackendClass *klass)
     backend_class->list_stored_controls      = pulse_backend_list_stored_controls;
     backend_class->set_default_input_stream  = pulse_backend_set_default_input_stream;
     backend_class->set_default_output_stream = pulse_backend_set_default_output_stream;
+    backend_class->begin_changes             = pulse_backend_begin_changes;
+    backend_class->commit_changes            = pulse_backend_commit_changes;
 }
 
 /* Called in the code generated by G_DEFINE_DYNAMIC_TYPE() */
@@ -291,6 +304,10 @@ pulse_backend_init (PulseBackend *pulse)
                                g_direct_equal,
                                NULL,
                                g_object_unref);
+
+    /* Maps objects to their links in the device, stream and ext-stream lists,
+     * the lists own the objects */
+    pulse->priv->list_links = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 static void
@@ -324,6 +341,7 @@ pulse_backend_finalize (GObject *object)
     g_hash_table_unref (pulse->priv->ext_streams);
     g_hash_table_unref (pulse->priv->sink_input_map);
     g_hash_table_unref (pulse->priv->source_output_map);
+    g_hash_table_unref (pulse->priv->list_links);
 
     G_OBJECT_CLASS (pulse_backend_parent_class)->finalize (object);
 }
@@ -348,6 +366,15 @@ pulse_backend_open (CafeMixerBackend *backend)
         return TRUE;
     }
 
+    /* Fail right away when there is no daemon to connect to, rather than going
+     * through a connection attempt which is known to fail */
+    if (pulse_connection_server_available (pulse->priv->server_address) == FALSE) {
+        g_debug ("No PulseAudio daemon is available");
+
+        PULSE_CHANGE_STATE (pulse, CAFE_MIXER_STATE_FAILED);
+        return FALSE;
+    }
+
     connection = pulse_connection_new (PULSE_APP_NAME (pulse),
                                        PULSE_APP_ID (pulse),
                                        PULSE_APP_VERSION (pulse),
@@ -462,6 +489,7 @@ pulse_backend_close (CafeMixerBackend *backend)
     free_list_streams (pulse);
     free_list_ext_streams (pulse);
 
+    g_hash_table_remove_all (pulse->priv->list_links);
     g_hash_table_remove_all (pulse->priv->devices);
     g_hash_table_remove_all (pulse->priv->sinks);
     g_hash_table_remove_all (pulse->priv->sources);
@@ -509,11 +537,7 @@ pulse_backend_list_devices (CafeMixerBackend *backend)
 
     pulse = PULSE_BACKEND (backend);
 
-    if (pulse->priv->devices_list == NULL) {
-        pulse->priv->devices_list = g_hash_table_get_values (pulse->priv->devices);
-        if (pulse->priv->devices_list != NULL)
-            g_list_foreach (pulse->priv->devices_list, (GFunc) g_object_ref, NULL);
-    }
+    /* The list is kept up to date when devices are added or removed */
     return pulse->priv->devices_list;
 }
 
@@ -526,20 +550,8 @@ pulse_backend_list_streams (CafeMixerBackend *backend)
 
     pulse = PULSE_BACKEND (backend);
 
-    if (pulse->priv->streams_list == NULL) {
-        GList *sinks;
-        GList *sources;
-
-        sinks = g_hash_table_get_values (pulse->priv->sinks);
-        if (sinks != NULL)
-            g_list_foreach (sinks, (GFunc) g_object_ref, NULL);
-
-        sources = g_hash_table_get_values (pulse->priv->sources);
-        if (sources != NULL)
-            g_list_foreach (sources, (GFunc) g_object_ref, NULL);
-
-        pulse->priv->streams_list = g_list_concat (sinks, sources);
-    }
+    /* The list of both sinks and sources is kept up to date when streams are
+     * added or removed */
     return pulse->priv->streams_list;
 }
 
@@ -552,11 +564,6 @@ pulse_backend_list_stored_controls (CafeMixerBackend *backend)
 
     pulse = PULSE_BACKEND (backend);
 
-    if (pulse->priv->ext_streams_list == NULL) {
-        pulse->priv->ext_streams_list = g_hash_table_get_values (pulse->priv->ext_streams);
-        if (pulse->priv->ext_streams_list != NULL)
-            g_list_foreach (pulse->priv->ext_streams_list, (GFunc) g_object_ref, NULL);
-    }
     return pulse->priv->ext_streams_list;
 }
 
@@ -606,6 +613,36 @@ pulse_backend_set_default_output_stream (CafeMixerBackend *backend,
     return TRUE;
 }
 
+static void
+pulse_backend_begin_changes (CafeMixerBackend *backend)
+{
+    PulseBackend *pulse;
+
+    g_return_if_fail (PULSE_IS_BACKEND (backend));
+
+    pulse = PULSE_BACKEND (backend);
+
+    /* Mute and volume writes are held back by the connection until the
+     * changes are committed, repeated writes to the same control only send
+     * the latest value */
+    if (pulse->priv->connection != NULL)
+        pulse_connection_begin_changes (pulse->priv->connection);
+}
+
+static void
+pulse_backend_commit_changes (CafeMixerBackend *backend)
+{
+    PulseBackend *pulse;
+
+    g_return_if_fail (PULSE_IS_BACKEND (backend));
+
+    pulse = PULSE_BACKEND (backend);
+
+    /* The connection might have been closed in the meantime */
+    if (pulse->priv->connection != NULL)
+        pulse_connection_commit_changes (pulse->priv->connection);
+}
+
 static void
 on_connection_state_notify (PulseConnection *connection,
 			    GParamSpec      *pspec G_GNUC_UNUSED,
@@ -765,7 +802,10 @@ on_connection_card_info (PulseConnection    *connection,
                              GUINT_TO_POINTER (info->index),
                              device);
 
-        free_list_devices (pulse);
+        list_add_object (pulse, &pulse->priv->devices_list, device);
+
+        _cafe_mixer_backend_index_device (CAFE_MIXER_BACKEND (pulse),
+                                          CAFE_MIXER_DEVICE (device));
         g_signal_emit_by_name (G_OBJECT (pulse),
                                "device-added",
                                cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
@@ -787,9 +827,10 @@ on_connection_card_removed (PulseConnection *connection G_GNUC_UNUSED,
 
     name = g_strdup (cafe_mixer_device_get_name (CAFE_MIXER_DEVICE (device)));
 
+    list_remove_object (pulse, &pulse->priv->devices_list, device);
+
     g_hash_table_remove (pulse->priv->devices, GUINT_TO_POINTER (index));
 
-    free_list_devices (pulse);
     g_signal_emit_by_name (G_OBJECT (pulse),
                            "device-removed",
                            name);
@@ -816,7 +857,7 @@ on_connection_sink_info (PulseConnection    *connection,
                              GUINT_TO_POINTER (info->index),
                              stream);
 
-        free_list_streams (pulse);
+        list_add_object (pulse, &pulse->priv->streams_list, stream);
 
         if (device != NULL) {
             pulse_device_add_stream (device, stream);
@@ -826,6 +867,8 @@ on_connection_sink_info (PulseConnection    *connection,
 
             /* Only emit when not a part of the device, otherwise emitted by
              * the main library */
+            _cafe_mixer_backend_index_stream (CAFE_MIXER_BACKEND (pulse),
+                                              CAFE_MIXER_STREAM (stream));
             g_signal_emit_by_name (G_OBJECT (pulse),
                                    "stream-added",
                                    name);
@@ -851,7 +894,7 @@ on_connection_sink_removed (PulseConnection *connection G_GNUC_UNUSED,
     g_object_ref (stream);
 
     g_hash_table_remove (pulse->priv->sinks, GUINT_TO_POINTER (idx));
-    free_list_streams (pulse);
+    list_remove_object (pulse, &pulse->priv->streams_list, stream);
 
     device = pulse_stream_get_device (stream);
     if (device != NULL) {
@@ -953,7 +996,7 @@ on_connection_source_info (PulseConnection      *connection,
                              GUINT_TO_POINTER (info->index),
                              stream);
 
-        free_list_streams (pulse);
+        list_add_object (pulse, &pulse->priv->streams_list, stream);
 
         if (device != NULL) {
             pulse_device_add_stream (device, stream);
@@ -963,6 +1006,8 @@ on_connection_source_info (PulseConnection      *connection,
 
             /* Only emit when not a part of the device, otherwise emitted by
              * the main library */
+            _cafe_mixer_backend_index_stream (CAFE_MIXER_BACKEND (pulse),
+                                              CAFE_MIXER_STREAM (stream));
             g_signal_emit_by_name (G_OBJECT (pulse),
                                    "stream-added",
                                    name);
@@ -988,7 +1033,7 @@ on_connection_source_removed (PulseConnection *connection G_GNUC_UNUSED,
     g_object_ref (stream);
 
     g_hash_table_remove (pulse->priv->sources, GUINT_TO_POINTER (idx));
-    free_list_streams (pulse);
+    list_remove_object (pulse, &pulse->priv->streams_list, stream);
 
     device = pulse_stream_get_device (stream);
     if (device != NULL) {
@@ -1095,8 +1140,10 @@ on_connection_ext_stream_info (PulseConnection                  *connection,
                              g_strdup (info->name),
                              ext);
 
-        free_list_ext_streams (pulse);
+        list_add_object (pulse, &pulse->priv->ext_streams_list, ext);
 
+        _cafe_mixer_backend_index_stored_control (CAFE_MIXER_BACKEND (pulse),
+                                                  CAFE_MIXER_STORED_CONTROL (ext));
         g_signal_emit_by_name (G_OBJECT (pulse),
                                "stored-control-added",
                                cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (ext)));
@@ -1127,21 +1174,25 @@ on_connection_ext_stream_loaded (PulseConnection *connection G_GNUC_UNUSED,
 				 PulseBackend    *pulse)
 {
     GHashTableIter iter;
-    gpointer       name;
     gpointer       ext;
 
     g_hash_table_iter_init (&iter, pulse->priv->ext_streams);
 
-    while (g_hash_table_iter_next (&iter, &name, &ext) == TRUE) {
+    while (g_hash_table_iter_next (&iter, NULL, &ext) == TRUE) {
         if (PULSE_GET_HANGING (ext) == FALSE)
             continue;
 
+        /* Removing the item frees the key, keep the object alive so its name
+         * can be used in the signal */
+        g_object_ref (ext);
+
         g_hash_table_iter_remove (&iter);
-        free_list_ext_streams (pulse);
+        list_remove_object (pulse, &pulse->priv->ext_streams_list, ext);
 
         g_signal_emit_by_name (G_OBJECT (pulse),
                                "stored-control-removed",
-                               name);
+                               cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (ext)));
+        g_object_unref (ext);
     }
 }
 
@@ -1218,6 +1269,31 @@ remove_source_output (PulseBackend *pulse, PulseSource *source, guint index)
     g_hash_table_remove (pulse->priv->source_output_map, GUINT_TO_POINTER (index));
 }
 
+static void
+list_add_object (PulseBackend *pulse, GList **list, gpointer object)
+{
+    /* The order of the items is not significant, prepend to avoid walking
+     * the list */
+    *list = g_list_prepend (*list, g_object_ref (object));
+
+    g_hash_table_insert (pulse->priv->list_links, object, *list);
+}
+
+static void
+list_remove_object (PulseBackend *pulse, GList **list, gpointer object)
+{
+    GList *item;
+
+    item = g_hash_table_lookup (pulse->priv->list_links, object);
+    if (G_UNLIKELY (item == NULL))
+        return;
+
+    g_hash_table_remove (pulse->priv->list_links, object);
+
+    *list = g_list_delete_link (*list, item);
+    g_object_unref (object);
+}
+
 static void
 free_list_devices (PulseBackend *pulse)
 {
@@ -17,28 +17,107 @@
 
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <string.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <glib-object.h>
 
 #include <pulse/pulseaudio.h>
 #include <pulse/glib-mainloop.h>
+#include <pulse/thread-mainloop.h>
 #include <pulse/ext-stream-restore.h>
 
 #include "pulse-connection.h"
 #include "pulse-enums.h"
 #include "pulse-enum-types.h"
+#include "pulse-helpers.h"
 #include "pulse-monitor.h"
 
+typedef enum {
+    PULSE_WRITE_SINK_MUTE,
+    PULSE_WRITE_SINK_VOLUME,
+    PULSE_WRITE_SINK_INPUT_MUTE,
+    PULSE_WRITE_SINK_INPUT_VOLUME,
+    PULSE_WRITE_SOURCE_MUTE,
+    PULSE_WRITE_SOURCE_VOLUME,
+    PULSE_WRITE_SOURCE_OUTPUT_MUTE,
+    PULSE_WRITE_SOURCE_OUTPUT_VOLUME
+} PulseWriteType;
+
+typedef struct
+{
+    PulseWriteType type;
+    guint32        index;
+    gboolean       mute;
+    pa_cvolume     volume;
+} PulseWrite;
+
+/* Setting this environment variable makes the connection run libpulse in its
+ * own thread rather than in the thread-default main context */
+#define PULSE_THREADED_ENV    "CAFE_MIXER_PULSE_THREADED"
+
+typedef enum {
+    PULSE_EVENT_STATE,
+    PULSE_EVENT_SUBSCRIBE,
+    PULSE_EVENT_RESTORE_SUBSCRIBE,
+    PULSE_EVENT_SERVER_INFO,
+    PULSE_EVENT_CARD_INFO,
+    PULSE_EVENT_SINK_INFO,
+    PULSE_EVENT_SOURCE_INFO,
+    PULSE_EVENT_SINK_INPUT_INFO,
+    PULSE_EVENT_SOURCE_OUTPUT_INFO,
+    PULSE_EVENT_EXT_STREAM_INFO
+} PulseEventType;
+
+/* Callback invocation queued in the libpulse thread and handled later in the
+ * main context, the info is a copy owned by the event as the info passed to
+ * the callback is only valid until the callback returns */
+typedef struct
+{
+    PulseEventType                type;
+    pa_context_state_t            state;
+    pa_subscription_event_type_t  t;
+    guint32                       idx;
+    gpointer                      info;
+    gint                          eol;
+} PulseEvent;
+
+/* Number of distinct objects of one facility with a pending request, which
+ * makes the connection request the whole list instead of the single objects */
+#define FETCH_LIST_THRESHOLD  8
+
+#define FETCH_N_FACILITIES    (PA_SUBSCRIPTION_EVENT_FACILITY_MASK + 1)
+
+/* Info request issued in response to a subscription event, the index is
+ * PA_INVALID_INDEX when the whole list is requested */
+typedef struct
+{
+    PulseConnection             *connection;
+    pa_subscription_event_type_t facility;
+    guint32                      index;
+    pa_operation                *op;
+    gboolean                     again;
+} PulseFetch;
+
 struct _PulseConnectionPrivate
 {
-    gchar               *server;
-    guint                outstanding;
-    pa_context          *context;
-    pa_proplist         *proplist;
-    pa_glib_mainloop    *mainloop;
-    gboolean             ext_streams_loading;
-    gboolean             ext_streams_dirty;
-    PulseConnectionState state;
+    gchar                *server;
+    guint                 outstanding;
+    pa_context           *context;
+    pa_proplist          *proplist;
+    pa_glib_mainloop     *mainloop;
+    pa_threaded_mainloop *threaded;
+    GMainContext         *owner;
+    GQueue                events;
+    GSource              *events_source;
+    gboolean              ext_streams_loading;
+    gboolean              ext_streams_dirty;
+    GHashTable           *changes;
+    GQueue                changes_order;
+    GHashTable           *fetches;
+    guint                 fetch_objects[FETCH_N_FACILITIES];
+    PulseConnectionState  state;
 };
 
 enum {
@@ -85,6 +164,15 @@ G_DEFINE_TYPE_WITH_PRIVATE (PulseConnection, pulse_connection, G_TYPE_OBJECT);
 
 static gchar    *create_app_name             (void);
 
+static gchar    *find_client_config          (void);
+static void      read_client_config          (const gchar                      *path,
+                                              gboolean                         *autospawn,
+                                              gchar                           **default_server);
+static void      read_client_config_file     (const gchar                      *path,
+                                              gboolean                         *autospawn,
+                                              gchar                           **default_server);
+static gboolean  is_socket                   (const gchar                      *path);
+
 static gboolean  load_lists                  (PulseConnection                  *connection);
 static gboolean  load_list_finished          (PulseConnection                  *connection);
 
@@ -125,12 +213,84 @@ static void      pulse_ext_stream_restore_cb (pa_context                       *
                                               int                               eol,
                                               void                             *userdata);
 
+static void      fetch_card_info_cb          (pa_context                       *c,
+                                              const pa_card_info               *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      fetch_sink_info_cb          (pa_context                       *c,
+                                              const pa_sink_info               *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      fetch_source_info_cb        (pa_context                       *c,
+                                              const pa_source_info             *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      fetch_sink_input_info_cb    (pa_context                       *c,
+                                              const pa_sink_input_info         *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      fetch_source_output_info_cb (pa_context                       *c,
+                                              const pa_source_output_info      *info,
+                                              int                               eol,
+                                              void                             *userdata);
+
 static void      change_state                (PulseConnection                  *connection,
                                               PulseConnectionState              state);
 
 static gboolean  process_pulse_operation     (PulseConnection                  *connection,
                                               pa_operation                     *op);
 
+static gboolean  defer_write                 (PulseConnection                  *connection,
+                                              PulseWriteType                    type,
+                                              guint32                           index,
+                                              gboolean                          mute,
+                                              const pa_cvolume                 *volume);
+static void      apply_write                 (PulseConnection                  *connection,
+                                              PulseWrite                       *write);
+
+static guint     write_hash                  (gconstpointer                     key);
+static gboolean  write_equal                 (gconstpointer                     a,
+                                              gconstpointer                     b);
+static void      write_free                  (gpointer                          write);
+
+static void      fetch_info                  (PulseConnection                  *connection,
+                                              pa_subscription_event_type_t      facility,
+                                              guint32                           index);
+static void      cancel_fetch_again          (PulseConnection                  *connection,
+                                              pa_subscription_event_type_t      facility,
+                                              guint32                           index);
+static gboolean  start_fetch                 (PulseFetch                       *fetch);
+static gboolean  is_event_storm              (PulseConnection                  *connection,
+                                              pa_subscription_event_type_t      facility,
+                                              guint32                           index);
+static gboolean  is_object_fetch             (gpointer                          fetch,
+                                              gpointer                          unused,
+                                              gpointer                          facility);
+static void      fetch_finished              (PulseFetch                       *fetch);
+
+static void      connection_lock             (PulseConnection                  *connection);
+static void      connection_unlock           (PulseConnection                  *connection);
+
+static void      release_context             (PulseConnection                  *connection);
+
+static void      handle_state                (PulseConnection                  *connection,
+                                              pa_context_state_t                state);
+
+static gboolean  in_pulse_thread             (PulseConnection                  *connection);
+static void      queue_event                 (PulseConnection                  *connection,
+                                              pa_context                       *c,
+                                              const PulseEvent                 *event);
+static gboolean  dispatch_events             (PulseConnection                  *connection);
+static void      handle_event                (PulseConnection                  *connection,
+                                              PulseEvent                       *event);
+static void      clear_events                (PulseConnection                  *connection);
+static void      event_free                  (PulseEvent                       *event);
+
+static guint     fetch_hash                  (gconstpointer                     key);
+static gboolean  fetch_equal                 (gconstpointer                     a,
+                                              gconstpointer                     b);
+static void      fetch_free                  (gpointer                          fetch);
+
 static void
 pulse_connection_class_init (PulseConnectionClass *klass)
 {
@@ -378,6 +538,14 @@ static void
 pulse_connection_init (PulseConnection *connection)
 {
     connection->priv = pulse_connection_get_instance_private (connection);
+
+    connection->priv->fetches = g_hash_table_new_full (fetch_hash,
+                                                       fetch_equal,
+                                                       fetch_free,
+                                                       NULL);
+
+    g_queue_init (&connection->priv->events);
+    g_queue_init (&connection->priv->changes_order);
 }
 
 static void
@@ -389,11 +557,38 @@ pulse_connection_finalize (GObject *object)
 
     g_free (connection->priv->server);
 
-    if (connection->priv->context != NULL)
-        pa_context_unref (connection->priv->context);
+    /* Monitors keep a reference to the connection, so nothing else uses the
+     * context now and it can go away before the libpulse thread is stopped,
+     * which must be done without holding the lock */
+    connection_lock (connection);
+
+    g_hash_table_remove_all (connection->priv->fetches);
+
+    release_context (connection);
+    clear_events (connection);
+
+    connection_unlock (connection);
 
     pa_proplist_free (connection->priv->proplist);
-    pa_glib_mainloop_free (connection->priv->mainloop);
+
+    if (connection->priv->threaded != NULL) {
+        pa_threaded_mainloop_stop (connection->priv->threaded);
+        pa_threaded_mainloop_free (connection->priv->threaded);
+
+        if (connection->priv->events_source != NULL) {
+            g_source_destroy (connection->priv->events_source);
+            g_source_unref (connection->priv->events_source);
+        }
+        g_main_context_unref (connection->priv->owner);
+    } else
+        pa_glib_mainloop_free (connection->priv->mainloop);
+
+    if (connection->priv->changes != NULL) {
+        g_queue_clear (&connection->priv->changes_order);
+        g_hash_table_unref (connection->priv->changes);
+    }
+
+    g_hash_table_unref (connection->priv->fetches);
 
     G_OBJECT_CLASS (pulse_connection_parent_class)->finalize (object);
 }
@@ -405,14 +600,31 @@ pulse_connection_new (const gchar *app_name,
                       const gchar *app_icon,
                       const gchar *server_address)
 {
-    pa_glib_mainloop *mainloop;
-    pa_proplist      *proplist;
-    PulseConnection  *connection;
-
-    mainloop = pa_glib_mainloop_new (g_main_context_get_thread_default ());
-    if (G_UNLIKELY (mainloop == NULL)) {
-        g_warning ("Failed to create PulseAudio main loop");
-        return NULL;
+    pa_glib_mainloop     *mainloop = NULL;
+    pa_threaded_mainloop *threaded = NULL;
+    pa_proplist          *proplist;
+    PulseConnection      *connection;
+
+    /* Protocol handling normally runs in the thread-default main context,
+     * optionally it runs in a separate thread and only the callbacks, which
+     * update the backend objects, are invoked in the main context */
+    if (g_getenv (PULSE_THREADED_ENV) != NULL) {
+        threaded = pa_threaded_mainloop_new ();
+        if (G_UNLIKELY (threaded == NULL)) {
+            g_warning ("Failed to create PulseAudio threaded main loop");
+            return NULL;
+        }
+        if (pa_threaded_mainloop_start (threaded) < 0) {
+            g_warning ("Failed to start PulseAudio main loop thread");
+            pa_threaded_mainloop_free (threaded);
+            return NULL;
+        }
+    } else {
+        mainloop = pa_glib_mainloop_new (g_main_context_get_thread_default ());
+        if (G_UNLIKELY (mainloop == NULL)) {
+            g_warning ("Failed to create PulseAudio main loop");
+            return NULL;
+        }
     }
 
     /* Create a property list to hold information about the application,
@@ -440,11 +652,66 @@ pulse_connection_new (const gchar *app_name,
                                NULL);
 
     connection->priv->mainloop = mainloop;
+    connection->priv->threaded = threaded;
     connection->priv->proplist = proplist;
 
+    if (threaded != NULL)
+        connection->priv->owner = g_main_context_ref_thread_default ();
+
     return connection;
 }
 
+gboolean
+pulse_connection_server_available (const gchar *server_address)
+{
+    gboolean     autospawn = TRUE;
+    gboolean     available = FALSE;
+    gchar       *default_server = NULL;
+    gchar       *path;
+    const gchar *env;
+
+    /* Only report the daemon as unavailable when it is certain that libpulse
+     * has nothing to connect to, anything else is left to libpulse */
+    if (server_address != NULL || g_getenv ("PULSE_SERVER") != NULL)
+        return TRUE;
+
+    /* The server may be announced in the properties of the X11 root window,
+     * which cannot be checked here */
+    if (g_getenv ("DISPLAY") != NULL)
+        return TRUE;
+
+    env = g_getenv ("PULSE_CLIENTCONFIG");
+    if (env != NULL)
+        path = g_strdup (env);
+    else
+        path = find_client_config ();
+
+    read_client_config (path, &autospawn, &default_server);
+    g_free (path);
+
+    if (default_server != NULL) {
+        g_free (default_server);
+        return TRUE;
+    }
+
+    /* Look for the socket of a per-user or a system-wide daemon */
+    env = g_getenv ("PULSE_RUNTIME_PATH");
+    if (env != NULL)
+        path = g_build_filename (env, "native", NULL);
+    else
+        path = g_build_filename (g_get_user_runtime_dir (), "pulse", "native", NULL);
+
+    available = is_socket (path) || is_socket ("/var/run/pulse/native");
+    g_free (path);
+
+    /* Without a running daemon, libpulse may still start one unless autospawn
+     * is disabled, which it always is for root */
+    if (available == FALSE && autospawn == TRUE && getuid () != 0)
+        available = TRUE;
+
+    return available;
+}
+
 gboolean
 pulse_connection_connect (PulseConnection *connection, gboolean wait_for_daemon)
 {
@@ -457,11 +724,19 @@ pulse_connection_connect (PulseConnection *connection, gboolean wait_for_daemon)
     if (connection->priv->state != PULSE_CONNECTION_DISCONNECTED)
         return TRUE;
 
-    mainloop = pa_glib_mainloop_get_api (connection->priv->mainloop);
-    context  = pa_context_new_with_proplist (mainloop,
-                                             NULL,
-                                             connection->priv->proplist);
+    if (connection->priv->threaded != NULL)
+        mainloop = pa_threaded_mainloop_get_api (connection->priv->threaded);
+    else
+        mainloop = pa_glib_mainloop_get_api (connection->priv->mainloop);
+
+    connection_lock (connection);
+
+    context = pa_context_new_with_proplist (mainloop,
+                                            NULL,
+                                            connection->priv->proplist);
     if (G_UNLIKELY (context == NULL)) {
+        connection_unlock (connection);
+
         g_warning ("Failed to create PulseAudio context");
         return FALSE;
     }
@@ -479,11 +754,14 @@ pulse_connection_connect (PulseConnection *connection, gboolean wait_for_daemon)
                             flags,
                             NULL) == 0) {
         connection->priv->context = context;
+        connection_unlock (connection);
+
         change_state (connection, PULSE_CONNECTION_CONNECTING);
         return TRUE;
     }
 
     pa_context_unref (context);
+    connection_unlock (connection);
     return FALSE;
 }
 
@@ -495,14 +773,28 @@ pulse_connection_disconnect (PulseConnection *connection)
     if (connection->priv->state == PULSE_CONNECTION_DISCONNECTED)
         return;
 
-    if (connection->priv->context)
-        pa_context_unref (connection->priv->context);
+    connection_lock (connection);
+
+    /* Cancel the requests before the context goes away */
+    g_hash_table_remove_all (connection->priv->fetches);
+
+    release_context (connection);
+
+    /* Events which have not been handled yet belong to the lost context */
+    clear_events (connection);
+
+    connection_unlock (connection);
 
-    connection->priv->context = NULL;
     connection->priv->outstanding = 0;
     connection->priv->ext_streams_loading = FALSE;
     connection->priv->ext_streams_dirty = FALSE;
 
+    /* Pending writes refer to indices of the lost connection */
+    if (connection->priv->changes != NULL) {
+        g_queue_clear (&connection->priv->changes_order);
+        g_hash_table_remove_all (connection->priv->changes);
+    }
+
     change_state (connection, PULSE_CONNECTION_DISCONNECTED);
 }
 
@@ -514,10 +806,53 @@ pulse_connection_get_state (PulseConnection *connection)
     return connection->priv->state;
 }
 
+void
+pulse_connection_begin_changes (PulseConnection *connection)
+{
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    if (connection->priv->changes != NULL)
+        return;
+
+    connection->priv->changes = g_hash_table_new_full (write_hash,
+                                                       write_equal,
+                                                       write_free,
+                                                       NULL);
+}
+
+void
+pulse_connection_commit_changes (PulseConnection *connection)
+{
+    GHashTable *changes;
+    GList      *list;
+
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    if (connection->priv->changes == NULL)
+        return;
+
+    /* Take the collected writes away first, so they are sent right away
+     * rather than deferred again */
+    changes = connection->priv->changes;
+    connection->priv->changes = NULL;
+
+    /* Writes are sent in the order in which they were first made, the hash
+     * table owns the writes and only coalesces them */
+    list = connection->priv->changes_order.head;
+    while (list != NULL) {
+        apply_write (connection, (PulseWrite *) list->data);
+        list = list->next;
+    }
+
+    g_queue_clear (&connection->priv->changes_order);
+    g_hash_table_unref (changes);
+}
+
 gboolean
 pulse_connection_load_server_info (PulseConnection *connection)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -525,17 +860,22 @@ pulse_connection_load_server_info (PulseConnection *connection)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_get_server_info (connection->priv->context,
                                      pulse_server_info_cb,
                                      connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -543,7 +883,8 @@ pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
-    if (index == PA_INVALID_INDEX)
+    connection_lock (connection);
+    if (index != PA_INVALID_INDEX)
         op = pa_context_get_card_info_by_index (connection->priv->context,
                                                 index,
                                                 pulse_card_info_cb,
@@ -553,13 +894,17 @@ pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
                                             pulse_card_info_cb,
                                             connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_card_info_name (PulseConnection *connection, const gchar *name)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
@@ -568,18 +913,23 @@ pulse_connection_load_card_info_name (PulseConnection *connection, const gchar *
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_get_card_info_by_name (connection->priv->context,
                                            name,
                                            pulse_card_info_cb,
                                            connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -587,7 +937,8 @@ pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
-    if (index == PA_INVALID_INDEX)
+    connection_lock (connection);
+    if (index != PA_INVALID_INDEX)
         op = pa_context_get_sink_info_by_index (connection->priv->context,
                                                 index,
                                                 pulse_sink_info_cb,
@@ -597,13 +948,17 @@ pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
                                             pulse_sink_info_cb,
                                             connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_sink_info_name (PulseConnection *connection, const gchar *name)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
@@ -612,18 +967,23 @@ pulse_connection_load_sink_info_name (PulseConnection *connection, const gchar *
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_get_sink_info_by_name (connection->priv->context,
                                            name,
                                            pulse_sink_info_cb,
                                            connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -631,7 +991,8 @@ pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 inde
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
-    if (index == PA_INVALID_INDEX)
+    connection_lock (connection);
+    if (index != PA_INVALID_INDEX)
         op = pa_context_get_sink_input_info (connection->priv->context,
                                              index,
                                              pulse_sink_input_info_cb,
@@ -641,13 +1002,17 @@ pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 inde
                                                   pulse_sink_input_info_cb,
                                                   connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -655,7 +1020,8 @@ pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
-    if (index == PA_INVALID_INDEX)
+    connection_lock (connection);
+    if (index != PA_INVALID_INDEX)
         op = pa_context_get_source_info_by_index (connection->priv->context,
                                                   index,
                                                   pulse_source_info_cb,
@@ -665,13 +1031,17 @@ pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
                                               pulse_source_info_cb,
                                               connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_source_info_name (PulseConnection *connection, const gchar *name)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
@@ -680,18 +1050,23 @@ pulse_connection_load_source_info_name (PulseConnection *connection, const gchar
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_get_source_info_by_name (connection->priv->context,
                                              name,
                                              pulse_source_info_cb,
                                              connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_source_output_info (PulseConnection *connection, guint32 index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -699,7 +1074,8 @@ pulse_connection_load_source_output_info (PulseConnection *connection, guint32 i
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
-    if (index == PA_INVALID_INDEX)
+    connection_lock (connection);
+    if (index != PA_INVALID_INDEX)
         op = pa_context_get_source_output_info (connection->priv->context,
                                                 index,
                                                 pulse_source_output_info_cb,
@@ -709,13 +1085,17 @@ pulse_connection_load_source_output_info (PulseConnection *connection, guint32 i
                                                      pulse_source_output_info_cb,
                                                      connection);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
 pulse_connection_load_ext_stream_info (PulseConnection *connection)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
@@ -741,11 +1121,15 @@ pulse_connection_load_ext_stream_info (PulseConnection *connection)
                    signals[EXT_STREAM_LOADING],
                    0);
 
+    connection_lock (connection);
     op = pa_ext_stream_restore_read (connection->priv->context,
                                      pulse_ext_stream_restore_cb,
                                      connection);
 
-    if (process_pulse_operation (connection, op) == FALSE) {
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    if (ret == FALSE) {
         connection->priv->ext_streams_loading = FALSE;
 
         g_signal_emit (G_OBJECT (connection),
@@ -766,8 +1150,10 @@ pulse_connection_create_monitor (PulseConnection *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return NULL;
 
-    return pulse_monitor_new (connection->priv->context,
+    return pulse_monitor_new (connection,
+                              connection->priv->context,
                               connection->priv->proplist,
+                              connection->priv->threaded,
                               index_source,
                               index_sink_input);
 }
@@ -777,6 +1163,7 @@ pulse_connection_set_default_sink (PulseConnection *connection,
                                    const gchar     *name)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
@@ -784,11 +1171,15 @@ pulse_connection_set_default_sink (PulseConnection *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_set_default_sink (connection->priv->context,
                                       name,
                                       NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -796,6 +1187,7 @@ pulse_connection_set_default_source (PulseConnection *connection,
                                      const gchar     *name)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
@@ -803,11 +1195,15 @@ pulse_connection_set_default_source (PulseConnection *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_set_default_source (connection->priv->context,
                                         name,
                                         NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -816,6 +1212,7 @@ pulse_connection_set_card_profile (PulseConnection *connection,
                                    const gchar     *profile)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (card != NULL, FALSE);
@@ -824,12 +1221,16 @@ pulse_connection_set_card_profile (PulseConnection *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_set_card_profile_by_name (connection->priv->context,
                                               card,
                                               profile,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -838,18 +1239,26 @@ pulse_connection_set_sink_mute (PulseConnection *connection,
                                 gboolean         mute)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SINK_MUTE, index, mute, NULL);
+
+    connection_lock (connection);
     op = pa_context_set_sink_mute_by_index (connection->priv->context,
                                             index,
                                             (int) mute,
                                             NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -858,6 +1267,7 @@ pulse_connection_set_sink_volume (PulseConnection  *connection,
                                   const pa_cvolume *volume)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
@@ -865,12 +1275,19 @@ pulse_connection_set_sink_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SINK_VOLUME, index, FALSE, volume);
+
+    connection_lock (connection);
     op = pa_context_set_sink_volume_by_index (connection->priv->context,
                                               index,
                                               volume,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -879,6 +1296,7 @@ pulse_connection_set_sink_port (PulseConnection *connection,
                                 const gchar     *port)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (port != NULL, FALSE);
@@ -886,12 +1304,16 @@ pulse_connection_set_sink_port (PulseConnection *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_set_sink_port_by_index (connection->priv->context,
                                             index,
                                             port,
                                             NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -900,18 +1322,26 @@ pulse_connection_set_sink_input_mute (PulseConnection  *connection,
                                       gboolean          mute)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SINK_INPUT_MUTE, index, mute, NULL);
+
+    connection_lock (connection);
     op = pa_context_set_sink_input_mute (connection->priv->context,
                                          index,
                                          (int) mute,
                                          NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -920,6 +1350,7 @@ pulse_connection_set_sink_input_volume (PulseConnection  *connection,
                                         const pa_cvolume *volume)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
@@ -927,12 +1358,19 @@ pulse_connection_set_sink_input_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SINK_INPUT_VOLUME, index, FALSE, volume);
+
+    connection_lock (connection);
     op = pa_context_set_sink_input_volume (connection->priv->context,
                                            index,
                                            volume,
                                            NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -941,18 +1379,26 @@ pulse_connection_set_source_mute (PulseConnection *connection,
                                   gboolean         mute)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SOURCE_MUTE, index, mute, NULL);
+
+    connection_lock (connection);
     op = pa_context_set_source_mute_by_index (connection->priv->context,
                                               index,
                                               (int) mute,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -961,6 +1407,7 @@ pulse_connection_set_source_volume (PulseConnection  *connection,
                                     const pa_cvolume *volume)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
@@ -968,12 +1415,19 @@ pulse_connection_set_source_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SOURCE_VOLUME, index, FALSE, volume);
+
+    connection_lock (connection);
     op = pa_context_set_source_volume_by_index (connection->priv->context,
                                                 index,
                                                 volume,
                                                 NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -982,6 +1436,7 @@ pulse_connection_set_source_port (PulseConnection *connection,
                                   const gchar     *port)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (port != NULL, FALSE);
@@ -989,12 +1444,16 @@ pulse_connection_set_source_port (PulseConnection *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_set_source_port_by_index (connection->priv->context,
                                               index,
                                               port,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1003,18 +1462,26 @@ pulse_connection_set_source_output_mute (PulseConnection *connection,
                                          gboolean         mute)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SOURCE_OUTPUT_MUTE, index, mute, NULL);
+
+    connection_lock (connection);
     op = pa_context_set_source_output_mute (connection->priv->context,
                                             index,
                                             (int) mute,
                                             NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1023,6 +1490,7 @@ pulse_connection_set_source_output_volume (PulseConnection  *connection,
                                            const pa_cvolume *volume)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
@@ -1030,12 +1498,19 @@ pulse_connection_set_source_output_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (connection->priv->changes != NULL)
+        return defer_write (connection, PULSE_WRITE_SOURCE_OUTPUT_VOLUME, index, FALSE, volume);
+
+    connection_lock (connection);
     op = pa_context_set_source_output_volume (connection->priv->context,
                                               index,
                                               volume,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1044,18 +1519,23 @@ pulse_connection_suspend_sink (PulseConnection *connection,
                                gboolean         suspend)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_suspend_sink_by_index (connection->priv->context,
                                            index,
                                            (int) suspend,
                                            NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1064,18 +1544,23 @@ pulse_connection_suspend_source (PulseConnection *connection,
                                  gboolean         suspend)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_suspend_source_by_index (connection->priv->context,
                                              index,
                                              (int) suspend,
                                              NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1084,18 +1569,23 @@ pulse_connection_move_sink_input (PulseConnection *connection,
                                   guint32          sink_index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_move_sink_input_by_index (connection->priv->context,
                                               index,
                                               sink_index,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1104,18 +1594,23 @@ pulse_connection_move_source_output (PulseConnection *connection,
                                      guint32          source_index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_move_source_output_by_index (connection->priv->context,
                                                  index,
                                                  source_index,
                                                  NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1123,17 +1618,22 @@ pulse_connection_kill_sink_input (PulseConnection *connection,
                                   guint32          index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_kill_sink_input (connection->priv->context,
                                      index,
                                      NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1141,17 +1641,22 @@ pulse_connection_kill_source_output (PulseConnection *connection,
                                      guint32          index)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_context_kill_source_output (connection->priv->context,
                                         index,
                                         NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1159,6 +1664,7 @@ pulse_connection_write_ext_stream (PulseConnection                  *connection,
                                    const pa_ext_stream_restore_info *info)
 {
     pa_operation *op;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (info != NULL, FALSE);
@@ -1166,13 +1672,17 @@ pulse_connection_write_ext_stream (PulseConnection                  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    connection_lock (connection);
     op = pa_ext_stream_restore_write (connection->priv->context,
                                       PA_UPDATE_REPLACE,
                                       info, 1,
                                       TRUE,
                                       NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
 }
 
 gboolean
@@ -1181,6 +1691,7 @@ pulse_connection_delete_ext_stream (PulseConnection *connection,
 {
     pa_operation *op;
     gchar       **names;
+    gboolean      ret;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
@@ -1192,13 +1703,514 @@ pulse_connection_delete_ext_stream (PulseConnection *connection,
     names[0] = (gchar *) name;
     names[1] = NULL;
 
+    connection_lock (connection);
     op = pa_ext_stream_restore_delete (connection->priv->context,
                                        (const char * const *) names,
                                        NULL, NULL);
 
     g_strfreev (names);
 
-    return process_pulse_operation (connection, op);
+    ret = process_pulse_operation (connection, op);
+    connection_unlock (connection);
+
+    return ret;
+}
+
+static gboolean
+defer_write (PulseConnection  *connection,
+             PulseWriteType    type,
+             guint32           index,
+             gboolean          mute,
+             const pa_cvolume *volume)
+{
+    PulseWrite  key;
+    PulseWrite *write;
+
+    key.type  = type;
+    key.index = index;
+
+    write = g_hash_table_lookup (connection->priv->changes, &key);
+    if (write == NULL) {
+        write = g_slice_new0 (PulseWrite);
+        write->type  = type;
+        write->index = index;
+
+        g_hash_table_add (connection->priv->changes, write);
+        g_queue_push_tail (&connection->priv->changes_order, write);
+    }
+
+    /* Only the latest value is sent when the changes are committed */
+    if (volume != NULL)
+        write->volume = *volume;
+    else
+        write->mute = mute;
+
+    return TRUE;
+}
+
+static void
+apply_write (PulseConnection *connection, PulseWrite *write)
+{
+    switch (write->type) {
+    case PULSE_WRITE_SINK_MUTE:
+        pulse_connection_set_sink_mute (connection, write->index, write->mute);
+        break;
+    case PULSE_WRITE_SINK_VOLUME:
+        pulse_connection_set_sink_volume (connection, write->index, &write->volume);
+        break;
+    case PULSE_WRITE_SINK_INPUT_MUTE:
+        pulse_connection_set_sink_input_mute (connection, write->index, write->mute);
+        break;
+    case PULSE_WRITE_SINK_INPUT_VOLUME:
+        pulse_connection_set_sink_input_volume (connection, write->index, &write->volume);
+        break;
+    case PULSE_WRITE_SOURCE_MUTE:
+        pulse_connection_set_source_mute (connection, write->index, write->mute);
+        break;
+    case PULSE_WRITE_SOURCE_VOLUME:
+        pulse_connection_set_source_volume (connection, write->index, &write->volume);
+        break;
+    case PULSE_WRITE_SOURCE_OUTPUT_MUTE:
+        pulse_connection_set_source_output_mute (connection, write->index, write->mute);
+        break;
+    case PULSE_WRITE_SOURCE_OUTPUT_VOLUME:
+        pulse_connection_set_source_output_volume (connection, write->index, &write->volume);
+        break;
+    }
+}
+
+static guint
+write_hash (gconstpointer key)
+{
+    const PulseWrite *write = key;
+
+    return (write->index << 3) ^ (guint) write->type;
+}
+
+static gboolean
+write_equal (gconstpointer a, gconstpointer b)
+{
+    const PulseWrite *w1 = a;
+    const PulseWrite *w2 = b;
+
+    return w1->type == w2->type && w1->index == w2->index;
+}
+
+static void
+write_free (gpointer write)
+{
+    g_slice_free (PulseWrite, write);
+}
+
+static void
+fetch_info (PulseConnection             *connection,
+            pa_subscription_event_type_t facility,
+            guint32                      index)
+{
+    PulseFetch  key;
+    PulseFetch *fetch;
+
+    key.facility = facility;
+    key.index    = PA_INVALID_INDEX;
+
+    /* Requests are tracked under the lock as they finish in the libpulse
+     * thread */
+    connection_lock (connection);
+
+    /* Under a storm of events, such as when a profile is switched, cancel
+     * the requests for single objects and request the whole list, which is
+     * then handled the same way as the lists loaded when connecting */
+    if (g_hash_table_contains (connection->priv->fetches, &key) == TRUE ||
+        is_event_storm (connection, facility, index) == TRUE) {
+        g_hash_table_foreach_remove (connection->priv->fetches,
+                                     is_object_fetch,
+                                     GUINT_TO_POINTER (facility));
+        index = PA_INVALID_INDEX;
+    }
+
+    key.index = index;
+
+    /* Events keep coming while the info is being requested, the info
+     * returned by the pending request may already be outdated, so only
+     * remember to request it once more when the request finishes */
+    fetch = g_hash_table_lookup (connection->priv->fetches, &key);
+    if (fetch != NULL) {
+        fetch->again = TRUE;
+        connection_unlock (connection);
+        return;
+    }
+
+    fetch = g_slice_new0 (PulseFetch);
+    fetch->connection = connection;
+    fetch->facility   = facility;
+    fetch->index      = index;
+
+    if (index != PA_INVALID_INDEX)
+        connection->priv->fetch_objects[facility]++;
+
+    if (start_fetch (fetch) == TRUE)
+        g_hash_table_add (connection->priv->fetches, fetch);
+    else
+        fetch_free (fetch);
+
+    connection_unlock (connection);
+}
+
+static void
+cancel_fetch_again (PulseConnection             *connection,
+                    pa_subscription_event_type_t facility,
+                    guint32                      index)
+{
+    PulseFetch  key;
+    PulseFetch *fetch;
+
+    key.facility = facility;
+    key.index    = index;
+
+    /* The object is gone, there is nothing to request once more */
+    connection_lock (connection);
+
+    fetch = g_hash_table_lookup (connection->priv->fetches, &key);
+    if (fetch != NULL)
+        fetch->again = FALSE;
+
+    connection_unlock (connection);
+}
+
+static gboolean
+start_fetch (PulseFetch *fetch)
+{
+    pa_context   *context = fetch->connection->priv->context;
+    pa_operation *op = NULL;
+
+    switch (fetch->facility) {
+    case PA_SUBSCRIPTION_EVENT_CARD:
+        if (fetch->index != PA_INVALID_INDEX)
+            op = pa_context_get_card_info_by_index (context,
+                                                    fetch->index,
+                                                    fetch_card_info_cb,
+                                                    fetch);
+        else
+            op = pa_context_get_card_info_list (context,
+                                                fetch_card_info_cb,
+                                                fetch);
+        break;
+    case PA_SUBSCRIPTION_EVENT_SINK:
+        if (fetch->index != PA_INVALID_INDEX)
+            op = pa_context_get_sink_info_by_index (context,
+                                                    fetch->index,
+                                                    fetch_sink_info_cb,
+                                                    fetch);
+        else
+            op = pa_context_get_sink_info_list (context,
+                                                fetch_sink_info_cb,
+                                                fetch);
+        break;
+    case PA_SUBSCRIPTION_EVENT_SOURCE:
+        if (fetch->index != PA_INVALID_INDEX)
+            op = pa_context_get_source_info_by_index (context,
+                                                      fetch->index,
+                                                      fetch_source_info_cb,
+                                                      fetch);
+        else
+            op = pa_context_get_source_info_list (context,
+                                                  fetch_source_info_cb,
+                                                  fetch);
+        break;
+    case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
+        if (fetch->index != PA_INVALID_INDEX)
+            op = pa_context_get_sink_input_info (context,
+                                                 fetch->index,
+                                                 fetch_sink_input_info_cb,
+                                                 fetch);
+        else
+            op = pa_context_get_sink_input_info_list (context,
+                                                      fetch_sink_input_info_cb,
+                                                      fetch);
+        break;
+    case PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT:
+        if (fetch->index != PA_INVALID_INDEX)
+            op = pa_context_get_source_output_info (context,
+                                                    fetch->index,
+                                                    fetch_source_output_info_cb,
+                                                    fetch);
+        else
+            op = pa_context_get_source_output_info_list (context,
+                                                         fetch_source_output_info_cb,
+                                                         fetch);
+        break;
+    default:
+        g_warn_if_reached ();
+        return FALSE;
+    }
+
+    if (G_UNLIKELY (op == NULL)) {
+        g_warning ("PulseAudio operation failed: %s",
+                   pa_strerror (pa_context_errno (context)));
+        return FALSE;
+    }
+
+    fetch->op = op;
+    return TRUE;
+}
+
+static gboolean
+is_event_storm (PulseConnection             *connection,
+                pa_subscription_event_type_t facility,
+                guint32                      index)
+{
+    PulseFetch key;
+
+    if (connection->priv->fetch_objects[facility] < FETCH_LIST_THRESHOLD)
+        return FALSE;
+
+    key.facility = facility;
+    key.index    = index;
+
+    /* Repeated events for an object which is already being requested are
+     * folded into its request, only another distinct object counts */
+    return g_hash_table_contains (connection->priv->fetches, &key) == FALSE;
+}
+
+static gboolean
+is_object_fetch (gpointer fetch, gpointer unused G_GNUC_UNUSED, gpointer facility)
+{
+    const PulseFetch *f = fetch;
+
+    return f->facility == (pa_subscription_event_type_t) GPOINTER_TO_UINT (facility) &&
+           f->index != PA_INVALID_INDEX;
+}
+
+static void
+fetch_finished (PulseFetch *fetch)
+{
+    pa_operation_unref (fetch->op);
+    fetch->op = NULL;
+
+    if (fetch->again == TRUE) {
+        fetch->again = FALSE;
+
+        if (start_fetch (fetch) == TRUE)
+            return;
+    }
+
+    /* Frees the fetch */
+    g_hash_table_remove (fetch->connection->priv->fetches, fetch);
+}
+
+static guint
+fetch_hash (gconstpointer key)
+{
+    const PulseFetch *fetch = key;
+
+    return (fetch->index << 4) ^ (guint) fetch->facility;
+}
+
+static gboolean
+fetch_equal (gconstpointer a, gconstpointer b)
+{
+    const PulseFetch *f1 = a;
+    const PulseFetch *f2 = b;
+
+    return f1->facility == f2->facility && f1->index == f2->index;
+}
+
+static void
+fetch_free (gpointer fetch)
+{
+    PulseFetch *f = fetch;
+
+    if (f->index != PA_INVALID_INDEX)
+        f->connection->priv->fetch_objects[f->facility]--;
+
+    if (f->op != NULL) {
+        pa_operation_cancel (f->op);
+        pa_operation_unref (f->op);
+    }
+    g_slice_free (PulseFetch, f);
+}
+
+static void
+connection_lock (PulseConnection *connection)
+{
+    if (connection->priv->threaded != NULL)
+        pa_threaded_mainloop_lock (connection->priv->threaded);
+}
+
+static void
+connection_unlock (PulseConnection *connection)
+{
+    if (connection->priv->threaded != NULL)
+        pa_threaded_mainloop_unlock (connection->priv->threaded);
+}
+
+static void
+release_context (PulseConnection *connection)
+{
+    pa_context *context = connection->priv->context;
+
+    if (context == NULL)
+        return;
+
+    /* Monitors may keep the context alive for a while, make sure it does not
+     * call back into the connection */
+    pa_context_set_state_callback (context, NULL, NULL);
+    pa_context_set_subscribe_callback (context, NULL, NULL);
+    pa_ext_stream_restore_set_subscribe_cb (context, NULL, NULL);
+
+    pa_context_disconnect (context);
+    pa_context_unref (context);
+
+    connection->priv->context = NULL;
+}
+
+static gboolean
+in_pulse_thread (PulseConnection *connection)
+{
+    return connection->priv->threaded != NULL &&
+           pa_threaded_mainloop_in_thread (connection->priv->threaded) != 0;
+}
+
+static void
+queue_event (PulseConnection  *connection,
+             pa_context       *c,
+             const PulseEvent *event)
+{
+    PulseEvent *copy;
+
+    copy = g_slice_dup (PulseEvent, event);
+
+    /* Skip callbacks of a context which has been disconnected meanwhile */
+    if (c != connection->priv->context) {
+        event_free (copy);
+        return;
+    }
+
+    g_queue_push_tail (&connection->priv->events, copy);
+
+    /* A single source handles all the events queued until it is dispatched,
+     * the libpulse thread never waits for the main context */
+    if (connection->priv->events_source == NULL) {
+        GSource *source = g_idle_source_new ();
+
+        g_source_set_priority (source, G_PRIORITY_DEFAULT);
+        g_source_set_callback (source,
+                               (GSourceFunc) dispatch_events,
+                               connection,
+                               NULL);
+        g_source_attach (source, connection->priv->owner);
+
+        connection->priv->events_source = source;
+    }
+}
+
+static gboolean
+dispatch_events (PulseConnection *connection)
+{
+    PulseEvent *event;
+
+    /* A signal handler may release the last reference to the connection */
+    g_object_ref (connection);
+
+    connection_lock (connection);
+    g_clear_pointer (&connection->priv->events_source, g_source_unref);
+    connection_unlock (connection);
+
+    /* The lock is only held while taking an event from the queue, so the
+     * libpulse thread keeps running while the event is handled */
+    while (TRUE) {
+        connection_lock (connection);
+        event = g_queue_pop_head (&connection->priv->events);
+        connection_unlock (connection);
+
+        if (event == NULL)
+            break;
+
+        handle_event (connection, event);
+        event_free (event);
+    }
+
+    g_object_unref (connection);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+handle_event (PulseConnection *connection, PulseEvent *event)
+{
+    pa_context *c = connection->priv->context;
+
+    switch (event->type) {
+    case PULSE_EVENT_STATE:
+        handle_state (connection, event->state);
+        break;
+    case PULSE_EVENT_SUBSCRIBE:
+        pulse_subscribe_cb (c, event->t, event->idx, connection);
+        break;
+    case PULSE_EVENT_RESTORE_SUBSCRIBE:
+        pulse_restore_subscribe_cb (c, connection);
+        break;
+    case PULSE_EVENT_SERVER_INFO:
+        pulse_server_info_cb (c, event->info, connection);
+        break;
+    case PULSE_EVENT_CARD_INFO:
+        pulse_card_info_cb (c, event->info, event->eol, connection);
+        break;
+    case PULSE_EVENT_SINK_INFO:
+        pulse_sink_info_cb (c, event->info, event->eol, connection);
+        break;
+    case PULSE_EVENT_SOURCE_INFO:
+        pulse_source_info_cb (c, event->info, event->eol, connection);
+        break;
+    case PULSE_EVENT_SINK_INPUT_INFO:
+        pulse_sink_input_info_cb (c, event->info, event->eol, connection);
+        break;
+    case PULSE_EVENT_SOURCE_OUTPUT_INFO:
+        pulse_source_output_info_cb (c, event->info, event->eol, connection);
+        break;
+    case PULSE_EVENT_EXT_STREAM_INFO:
+        pulse_ext_stream_restore_cb (c, event->info, event->eol, connection);
+        break;
+    }
+}
+
+static void
+clear_events (PulseConnection *connection)
+{
+    PulseEvent *event;
+
+    while ((event = g_queue_pop_head (&connection->priv->events)) != NULL)
+        event_free (event);
+}
+
+static void
+event_free (PulseEvent *event)
+{
+    switch (event->type) {
+    case PULSE_EVENT_SERVER_INFO:
+        pulse_server_info_free (event->info);
+        break;
+    case PULSE_EVENT_CARD_INFO:
+        pulse_card_info_free (event->info);
+        break;
+    case PULSE_EVENT_SINK_INFO:
+        pulse_sink_info_free (event->info);
+        break;
+    case PULSE_EVENT_SOURCE_INFO:
+        pulse_source_info_free (event->info);
+        break;
+    case PULSE_EVENT_SINK_INPUT_INFO:
+        pulse_sink_input_info_free (event->info);
+        break;
+    case PULSE_EVENT_SOURCE_OUTPUT_INFO:
+        pulse_source_output_info_free (event->info);
+        break;
+    case PULSE_EVENT_EXT_STREAM_INFO:
+        pulse_ext_stream_info_free (event->info);
+        break;
+    default:
+        break;
+    }
+    g_slice_free (PulseEvent, event);
 }
 
 static gchar *
@@ -1218,6 +2230,125 @@ create_app_name (void)
     return g_strdup_printf ("libcafemixer-%lu", (gulong) getpid ());
 }
 
+/* Like libpulse, use the first configuration file found, the per-user one
+ * taking precedence over the system-wide one */
+static gchar *
+find_client_config (void)
+{
+    gchar *path;
+
+    path = g_build_filename (g_get_user_config_dir (), "pulse", "client.conf", NULL);
+    if (g_file_test (path, G_FILE_TEST_IS_REGULAR) == TRUE)
+        return path;
+    g_free (path);
+
+    path = g_build_filename (g_get_home_dir (), ".pulse", "client.conf", NULL);
+    if (g_file_test (path, G_FILE_TEST_IS_REGULAR) == TRUE)
+        return path;
+    g_free (path);
+
+    return g_build_filename (PULSE_SYSCONF_DIR, "client.conf", NULL);
+}
+
+/* Reads the configuration file followed by the *.conf files in its .d
+ * directory in alphabetical order, later values override earlier ones */
+static void
+read_client_config (const gchar *path,
+                    gboolean    *autospawn,
+                    gchar      **default_server)
+{
+    GDir        *dir;
+    GSList      *names = NULL;
+    GSList      *list;
+    const gchar *name;
+    gchar       *dirname;
+
+    read_client_config_file (path, autospawn, default_server);
+
+    dirname = g_strconcat (path, ".d", NULL);
+
+    dir = g_dir_open (dirname, 0, NULL);
+    if (dir == NULL) {
+        g_free (dirname);
+        return;
+    }
+
+    while ((name = g_dir_read_name (dir)) != NULL)
+        if (g_str_has_suffix (name, ".conf") == TRUE)
+            names = g_slist_insert_sorted (names,
+                                           g_strdup (name),
+                                           (GCompareFunc) strcmp);
+
+    g_dir_close (dir);
+
+    for (list = names; list != NULL; list = list->next) {
+        gchar *file = g_build_filename (dirname, list->data, NULL);
+
+        read_client_config_file (file, autospawn, default_server);
+        g_free (file);
+    }
+
+    g_slist_free_full (names, g_free);
+    g_free (dirname);
+}
+
+static void
+read_client_config_file (const gchar *path,
+                         gboolean    *autospawn,
+                         gchar      **default_server)
+{
+    gchar  *contents;
+    gchar **lines;
+    guint   i;
+
+    if (g_file_get_contents (path, &contents, NULL, NULL) == FALSE)
+        return;
+
+    /* The file consists of "key = value" lines with ; or # comments */
+    lines = g_strsplit (contents, "\n", -1);
+
+    for (i = 0; lines[i] != NULL; i++) {
+        gchar *line = g_strstrip (lines[i]);
+        gchar *value;
+
+        if (line[0] == '#' || line[0] == ';')
+            continue;
+
+        value = strchr (line, '=');
+        if (value == NULL)
+            continue;
+
+        *value++ = '\0';
+
+        g_strstrip (line);
+        g_strstrip (value);
+
+        if (strcmp (line, "autospawn") == 0) {
+            *autospawn = g_ascii_strcasecmp (value, "no") != 0 &&
+                         g_ascii_strcasecmp (value, "false") != 0 &&
+                         g_ascii_strcasecmp (value, "off") != 0 &&
+                         strcmp (value, "0") != 0;
+        } else if (strcmp (line, "default-server") == 0) {
+            g_free (*default_server);
+            *default_server = (*value != '\0') ? g_strdup (value) : NULL;
+        }
+    }
+
+    g_strfreev (lines);
+    g_free (contents);
+}
+
+static gboolean
+is_socket (const gchar *path)
+{
+    GStatBuf st;
+
+    if (g_stat (path, &st) != 0)
+        return FALSE;
+
+    return S_ISSOCK (st.st_mode);
+}
+
 static gboolean
 load_lists (PulseConnection *connection)
 {
@@ -1320,15 +2451,29 @@ load_list_finished (PulseConnection *connection)
 static void
 pulse_state_cb (pa_context *c, void *userdata)
 {
-    PulseConnection    *connection;
-    pa_context_state_t  state;
+    PulseConnection *connection;
 
     connection = PULSE_CONNECTION (userdata);
 
-    state = pa_context_get_state (c);
+    /* Handle the state in the main context when running in the libpulse
+     * thread, the state is read here as it may change again meanwhile */
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_STATE, };
+
+        event.state = pa_context_get_state (c);
+        queue_event (connection, c, &event);
+        return;
+    }
+
+    handle_state (connection, pa_context_get_state (c));
+}
 
+static void
+handle_state (PulseConnection *connection, pa_context_state_t state)
+{
     if (state == PA_CONTEXT_READY) {
         pa_operation *op;
+        gboolean      ret;
 
         if (connection->priv->state == PULSE_CONNECTION_LOADING ||
             connection->priv->state == PULSE_CONNECTION_CONNECTED) {
@@ -1336,6 +2481,8 @@ pulse_state_cb (pa_context *c, void *userdata)
             return;
         }
 
+        connection_lock (connection);
+
         /* We are connected, let's subscribe to notifications and load the
          * initial lists */
         pa_context_set_subscribe_callback (connection->priv->context,
@@ -1361,12 +2508,17 @@ pulse_state_cb (pa_context *c, void *userdata)
                                    PA_SUBSCRIPTION_MASK_SOURCE_OUTPUT,
                                    NULL, NULL);
 
-        if (process_pulse_operation (connection, op) == TRUE) {
+        ret = process_pulse_operation (connection, op);
+        connection_unlock (connection);
+
+        if (ret == TRUE) {
             change_state (connection, PULSE_CONNECTION_LOADING);
 
-            if (load_lists (connection) == FALSE)
-                state = PA_CONTEXT_FAILED;
-        } else
+            connection_lock (connection);
+            ret = load_lists (connection);
+            connection_unlock (connection);
+        }
+        if (ret == FALSE)
             state = PA_CONTEXT_FAILED;
     }
 
@@ -1384,85 +2536,113 @@ pulse_state_cb (pa_context *c, void *userdata)
 }
 
 static void
-pulse_subscribe_cb (pa_context                   *c G_GNUC_UNUSED,
+pulse_subscribe_cb (pa_context                   *c,
 		    pa_subscription_event_type_t  t,
 		    uint32_t                      idx,
 		    void                         *userdata)
 {
-    PulseConnection *connection;
+    PulseConnection             *connection;
+    pa_subscription_event_type_t facility;
 
     connection = PULSE_CONNECTION (userdata);
+    facility   = t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_SUBSCRIBE, };
 
-    switch (t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) {
+        event.t   = t;
+        event.idx = idx;
+        queue_event (connection, c, &event);
+        return;
+    }
+
+    switch (facility) {
     case PA_SUBSCRIPTION_EVENT_SERVER:
         pulse_connection_load_server_info (connection);
         break;
 
     case PA_SUBSCRIPTION_EVENT_CARD:
-        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
+        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
+            cancel_fetch_again (connection, facility, idx);
+
             g_signal_emit (G_OBJECT (connection),
                            signals[CARD_REMOVED],
                            0,
                            idx);
-        else
-            pulse_connection_load_card_info (connection, idx);
+        } else
+            fetch_info (connection, facility, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SINK:
-        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
+        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
+            cancel_fetch_again (connection, facility, idx);
+
             g_signal_emit (G_OBJECT (connection),
                            signals[SINK_REMOVED],
                            0,
                            idx);
-        else
-            pulse_connection_load_sink_info (connection, idx);
+        } else
+            fetch_info (connection, facility, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
-        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
+        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
+            cancel_fetch_again (connection, facility, idx);
+
             g_signal_emit (G_OBJECT (connection),
                            signals[SINK_INPUT_REMOVED],
                            0,
                            idx);
-        else
-            pulse_connection_load_sink_input_info (connection, idx);
+        } else
+            fetch_info (connection, facility, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SOURCE:
-        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
+        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
+            cancel_fetch_again (connection, facility, idx);
+
             g_signal_emit (G_OBJECT (connection),
                            signals[SOURCE_REMOVED],
                            0,
                            idx);
-        else
-            pulse_connection_load_source_info (connection, idx);
+        } else
+            fetch_info (connection, facility, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT:
-        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
+        if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
+            cancel_fetch_again (connection, facility, idx);
+
             g_signal_emit (G_OBJECT (connection),
                            signals[SOURCE_OUTPUT_REMOVED],
                            0,
                            idx);
-        else
-            pulse_connection_load_source_output_info (connection, idx);
+        } else
+            fetch_info (connection, facility, idx);
         break;
     }
 }
 
 static void
-pulse_restore_subscribe_cb (pa_context *c G_GNUC_UNUSED,
+pulse_restore_subscribe_cb (pa_context *c,
 			    void       *userdata)
 {
     PulseConnection *connection;
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_RESTORE_SUBSCRIBE, };
+
+        queue_event (connection, c, &event);
+        return;
+    }
+
     pulse_connection_load_ext_stream_info (connection);
 }
 
 static void
-pulse_server_info_cb (pa_context           *c G_GNUC_UNUSED,
+pulse_server_info_cb (pa_context           *c,
 		      const pa_server_info *info,
 		      void                 *userdata)
 {
@@ -1470,6 +2650,14 @@ pulse_server_info_cb (pa_context           *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_SERVER_INFO, };
+
+        event.info = pulse_server_info_copy (info);
+        queue_event (connection, c, &event);
+        return;
+    }
+
     g_signal_emit (G_OBJECT (connection),
                    signals[SERVER_INFO],
                    0,
@@ -1482,7 +2670,7 @@ pulse_server_info_cb (pa_context           *c G_GNUC_UNUSED,
 }
 
 static void
-pulse_card_info_cb (pa_context         *c G_GNUC_UNUSED,
+pulse_card_info_cb (pa_context         *c,
 		    const pa_card_info *info,
 		    int                 eol,
 		    void               *userdata)
@@ -1491,6 +2679,17 @@ pulse_card_info_cb (pa_context         *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_CARD_INFO, };
+
+        if (eol == 0)
+            event.info = pulse_card_info_copy (info);
+
+        event.eol = eol;
+        queue_event (connection, c, &event);
+        return;
+    }
+
     if (eol) {
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
@@ -1504,7 +2703,7 @@ pulse_card_info_cb (pa_context         *c G_GNUC_UNUSED,
 }
 
 static void
-pulse_sink_info_cb (pa_context         *c G_GNUC_UNUSED,
+pulse_sink_info_cb (pa_context         *c,
 		    const pa_sink_info *info,
 		    int                 eol,
 		    void               *userdata)
@@ -1513,6 +2712,17 @@ pulse_sink_info_cb (pa_context         *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_SINK_INFO, };
+
+        if (eol == 0)
+            event.info = pulse_sink_info_copy (info);
+
+        event.eol = eol;
+        queue_event (connection, c, &event);
+        return;
+    }
+
     if (eol) {
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
@@ -1526,7 +2736,7 @@ pulse_sink_info_cb (pa_context         *c G_GNUC_UNUSED,
 }
 
 static void
-pulse_sink_input_info_cb (pa_context               *c G_GNUC_UNUSED,
+pulse_sink_input_info_cb (pa_context               *c,
 			  const pa_sink_input_info *info,
 			  int                       eol,
 			  void                     *userdata)
@@ -1535,6 +2745,17 @@ pulse_sink_input_info_cb (pa_context               *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_SINK_INPUT_INFO, };
+
+        if (eol == 0)
+            event.info = pulse_sink_input_info_copy (info);
+
+        event.eol = eol;
+        queue_event (connection, c, &event);
+        return;
+    }
+
     if (eol) {
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
@@ -1548,7 +2769,7 @@ pulse_sink_input_info_cb (pa_context               *c G_GNUC_UNUSED,
 }
 
 static void
-pulse_source_info_cb (pa_context           *c G_GNUC_UNUSED,
+pulse_source_info_cb (pa_context           *c,
 		      const pa_source_info *info,
 		      int                   eol,
 		      void                 *userdata)
@@ -1557,6 +2778,17 @@ pulse_source_info_cb (pa_context           *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_SOURCE_INFO, };
+
+        if (eol == 0)
+            event.info = pulse_source_info_copy (info);
+
+        event.eol = eol;
+        queue_event (connection, c, &event);
+        return;
+    }
+
     if (eol) {
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
@@ -1570,7 +2802,7 @@ pulse_source_info_cb (pa_context           *c G_GNUC_UNUSED,
 }
 
 static void
-pulse_source_output_info_cb (pa_context                  *c G_GNUC_UNUSED,
+pulse_source_output_info_cb (pa_context                  *c,
 			     const pa_source_output_info *info,
 			     int                          eol,
 			     void                        *userdata)
@@ -1579,6 +2811,17 @@ pulse_source_output_info_cb (pa_context                  *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_SOURCE_OUTPUT_INFO, };
+
+        if (eol == 0)
+            event.info = pulse_source_output_info_copy (info);
+
+        event.eol = eol;
+        queue_event (connection, c, &event);
+        return;
+    }
+
     if (eol) {
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
@@ -1592,7 +2835,7 @@ pulse_source_output_info_cb (pa_context                  *c G_GNUC_UNUSED,
 }
 
 static void
-pulse_ext_stream_restore_cb (pa_context                       *c G_GNUC_UNUSED,
+pulse_ext_stream_restore_cb (pa_context                       *c,
 			     const pa_ext_stream_restore_info *info,
 			     int                               eol,
 			     void                             *userdata)
@@ -1601,6 +2844,17 @@ pulse_ext_stream_restore_cb (pa_context                       *c G_GNUC_UNUSED,
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (in_pulse_thread (connection) == TRUE) {
+        PulseEvent event = { PULSE_EVENT_EXT_STREAM_INFO, };
+
+        if (eol == 0)
+            event.info = pulse_ext_stream_info_copy (info);
+
+        event.eol = eol;
+        queue_event (connection, c, &event);
+        return;
+    }
+
     if (eol) {
         connection->priv->ext_streams_loading = FALSE;
         g_signal_emit (G_OBJECT (connection),
@@ -1624,6 +2878,86 @@ pulse_ext_stream_restore_cb (pa_context                       *c G_GNUC_UNUSED,
                    info);
 }
 
+static void
+fetch_card_info_cb (pa_context         *c,
+                   const pa_card_info *info,
+                   int                 eol,
+                   void               *userdata)
+{
+    PulseFetch *fetch = userdata;
+
+    if (eol) {
+        fetch_finished (fetch);
+        return;
+    }
+
+    pulse_card_info_cb (c, info, eol, fetch->connection);
+}
+
+static void
+fetch_sink_info_cb (pa_context         *c,
+                   const pa_sink_info *info,
+                   int                 eol,
+                   void               *userdata)
+{
+    PulseFetch *fetch = userdata;
+
+    if (eol) {
+        fetch_finished (fetch);
+        return;
+    }
+
+    pulse_sink_info_cb (c, info, eol, fetch->connection);
+}
+
+static void
+fetch_source_info_cb (pa_context           *c,
+                     const pa_source_info *info,
+                     int                   eol,
+                     void                 *userdata)
+{
+    PulseFetch *fetch = userdata;
+
+    if (eol) {
+        fetch_finished (fetch);
+        return;
+    }
+
+    pulse_source_info_cb (c, info, eol, fetch->connection);
+}
+
+static void
+fetch_sink_input_info_cb (pa_context               *c,
+                         const pa_sink_input_info *info,
+                         int                       eol,
+                         void                     *userdata)
+{
+    PulseFetch *fetch = userdata;
+
+    if (eol) {
+        fetch_finished (fetch);
+        return;
+    }
+
+    pulse_sink_input_info_cb (c, info, eol, fetch->connection);
+}
+
+static void
+fetch_source_output_info_cb (pa_context                  *c,
+                            const pa_source_output_info *info,
+                            int                          eol,
+                            void                        *userdata)
+{
+    PulseFetch *fetch = userdata;
+
+    if (eol) {
+        fetch_finished (fetch);
+        return;
+    }
+
+    pulse_source_output_info_cb (c, info, eol, fetch->connection);
+}
+
 static void
 change_state (PulseConnection *connection, PulseConnectionState state)
 {
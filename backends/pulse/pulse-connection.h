@@ -100,12 +100,17 @@ PulseConnection *    pulse_connection_new                      (const gchar
                                                                 const gchar                      *app_icon,
                                                                 const gchar                      *server_address);
 
+gboolean             pulse_connection_server_available         (const gchar                      *server_address);
+
 gboolean             pulse_connection_connect                  (PulseConnection                  *connection,
                                                                 gboolean                          wait_for_daemon);
 void                 pulse_connection_disconnect               (PulseConnection                  *connection);
 
 PulseConnectionState pulse_connection_get_state                (PulseConnection                  *connection);
 
+void                 pulse_connection_begin_changes            (PulseConnection                  *connection);
+void                 pulse_connection_commit_changes           (PulseConnection                  *connection);
+
 gboolean             pulse_connection_load_server_info         (PulseConnection                  *connection);
 
 gboolean             pulse_connection_load_card_info           (PulseConnection                  *connection,
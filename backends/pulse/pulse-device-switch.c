@@ -43,8 +43,6 @@ static const GList *pulse_device_switch_list_options      (CafeMixerSwitch
 
 static gint         compare_profiles                      (gconstpointer          a,
                                                            gconstpointer          b);
-static gint         compare_profile_name                  (gconstpointer          a,
-                                                           gconstpointer          b);
 
 static void
 pulse_device_switch_class_init (PulseDeviceSwitchClass *klass)
@@ -104,6 +102,9 @@ pulse_device_switch_add_profile (PulseDeviceSwitch *swtch, PulseDeviceProfile *p
     swtch->priv->profiles = g_list_insert_sorted (swtch->priv->profiles,
                                                   g_object_ref (profile),
                                                   compare_profiles);
+
+    _cafe_mixer_switch_index_option (CAFE_MIXER_SWITCH (swtch),
+                                     CAFE_MIXER_SWITCH_OPTION (profile));
 }
 
 void
@@ -120,17 +121,17 @@ pulse_device_switch_set_active_profile (PulseDeviceSwitch  *swtch,
 void
 pulse_device_switch_set_active_profile_by_name (PulseDeviceSwitch *swtch, const gchar *name)
 {
-    GList *item;
+    CafeMixerSwitchOption *option;
 
     g_return_if_fail (PULSE_IS_DEVICE_SWITCH (swtch));
     g_return_if_fail (name != NULL);
 
-    item = g_list_find_custom (swtch->priv->profiles, name, compare_profile_name);
-    if (G_UNLIKELY (item == NULL)) {
+    option = cafe_mixer_switch_get_option (CAFE_MIXER_SWITCH (swtch), name);
+    if (G_UNLIKELY (option == NULL)) {
         g_debug ("Invalid device switch profile name %s", name);
         return;
     }
-    pulse_device_switch_set_active_profile (swtch, PULSE_DEVICE_PROFILE (item->data));
+    pulse_device_switch_set_active_profile (swtch, PULSE_DEVICE_PROFILE (option));
 }
 
 static gboolean
@@ -169,12 +170,3 @@ compare_profiles (gconstpointer a, gconstpointer b)
     return pulse_device_profile_get_priority (PULSE_DEVICE_PROFILE (b)) -
            pulse_device_profile_get_priority (PULSE_DEVICE_PROFILE (a));
 }
-
-static gint
-compare_profile_name (gconstpointer a, gconstpointer b)
-{
-    PulseDeviceProfile *profile = PULSE_DEVICE_PROFILE (a);
-    const gchar        *name    = (const gchar *) b;
-
-    return strcmp (pulse_device_profile_get_name (profile), name);
-}
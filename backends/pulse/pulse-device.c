@@ -75,6 +75,8 @@ static const GList *    pulse_device_list_switches (CafeMixerDevice    *mmd);
 static void             pulse_device_load          (PulseDevice        *device,
                                                     const pa_card_info *info);
 
+static void             remove_list_stream         (PulseDevice        *device,
+                                                    PulseStream        *stream);
 static void             free_list_streams          (PulseDevice        *device);
 
 static void
@@ -268,11 +270,15 @@ pulse_device_add_stream (PulseDevice *device, PulseStream *stream)
 
     name = cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (stream));
 
+    if (G_UNLIKELY (g_hash_table_contains (device->priv->streams, name) == TRUE))
+        remove_list_stream (device, g_hash_table_lookup (device->priv->streams, name));
+
     g_hash_table_insert (device->priv->streams,
                          g_strdup (name),
                          g_object_ref (stream));
 
-    free_list_streams (device);
+    device->priv->streams_list =
+        g_list_prepend (device->priv->streams_list, g_object_ref (stream));
 
     g_signal_emit_by_name (G_OBJECT (device),
                            "stream-added",
@@ -289,7 +295,7 @@ pulse_device_remove_stream (PulseDevice *device, PulseStream *stream)
 
     name = cafe_mixer_stream_get_name (CAFE_MIXER_STREAM (stream));
 
-    free_list_streams (device);
+    remove_list_stream (device, stream);
 
     g_hash_table_remove (device->priv->streams, name);
     g_signal_emit_by_name (G_OBJECT (device),
@@ -340,11 +346,7 @@ pulse_device_list_streams (CafeMixerDevice *mmd)
 
     device = PULSE_DEVICE (mmd);
 
-    if (device->priv->streams_list == NULL) {
-        device->priv->streams_list = g_hash_table_get_values (device->priv->streams);
-        if (device->priv->streams_list != NULL)
-            g_list_foreach (device->priv->streams_list, (GFunc) g_object_ref, NULL);
-    }
+    /* The list is kept up to date when streams are added or removed */
     return device->priv->streams_list;
 }
 
@@ -386,6 +388,9 @@ pulse_device_load (PulseDevice *device, const pa_card_info *info)
                                                          device);
 
         device->priv->pswitch_list = g_list_prepend (NULL, device->priv->pswitch);
+
+        _cafe_mixer_device_index_switch (CAFE_MIXER_DEVICE (device),
+                                         CAFE_MIXER_DEVICE_SWITCH (device->priv->pswitch));
     }
 
     for (i = 0; i < info->n_profiles; i++) {
@@ -409,6 +414,19 @@ pulse_device_load (PulseDevice *device, const pa_card_info *info)
     }
 }
 
+static void
+remove_list_stream (PulseDevice *device, PulseStream *stream)
+{
+    GList *item;
+
+    item = g_list_find (device->priv->streams_list, stream);
+    if (G_UNLIKELY (item == NULL))
+        return;
+
+    device->priv->streams_list = g_list_delete_link (device->priv->streams_list, item);
+    g_object_unref (stream);
+}
+
 static void
 free_list_streams (PulseDevice *device)
 {
@@ -21,6 +21,7 @@
 #include <libcafemixer/cafemixer-enums.h>
 
 #include <pulse/pulseaudio.h>
+#include <pulse/ext-stream-restore.h>
 
 #include "pulse-helpers.h"
 
@@ -111,3 +112,480 @@ pulse_convert_media_role_name (const gchar *name)
 
     return CAFE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN;
 }
+
+/* The info passed to libpulse callbacks is only valid until the callback
+ * returns, these functions make copies of the parts used by the backend when
+ * the info is handed from the libpulse thread to the main context */
+static pa_card_profile_info2 *
+card_profile_copy (const pa_card_profile_info2 *profile)
+{
+    pa_card_profile_info2 *copy = g_slice_new0 (pa_card_profile_info2);
+
+    copy->name        = g_strdup (profile->name);
+    copy->description = g_strdup (profile->description);
+    copy->n_sinks     = profile->n_sinks;
+    copy->n_sources   = profile->n_sources;
+    copy->priority    = profile->priority;
+    copy->available   = profile->available;
+
+    return copy;
+}
+
+static void
+card_profile_free (pa_card_profile_info2 *profile)
+{
+    g_free ((gchar *) profile->name);
+    g_free ((gchar *) profile->description);
+
+    g_slice_free (pa_card_profile_info2, profile);
+}
+
+static pa_card_port_info *
+card_port_copy (const pa_card_port_info *port)
+{
+    pa_card_port_info *copy = g_slice_new0 (pa_card_port_info);
+
+    copy->name        = g_strdup (port->name);
+    copy->description = g_strdup (port->description);
+    copy->priority    = port->priority;
+    copy->available   = port->available;
+    copy->direction   = port->direction;
+
+    if (port->proplist != NULL)
+        copy->proplist = pa_proplist_copy (port->proplist);
+
+    return copy;
+}
+
+static void
+card_port_free (pa_card_port_info *port)
+{
+    g_free ((gchar *) port->name);
+    g_free ((gchar *) port->description);
+
+    if (port->proplist != NULL)
+        pa_proplist_free (port->proplist);
+
+    g_slice_free (pa_card_port_info, port);
+}
+
+static pa_sink_port_info *
+sink_port_copy (const pa_sink_port_info *port)
+{
+    pa_sink_port_info *copy = g_slice_new0 (pa_sink_port_info);
+
+    copy->name        = g_strdup (port->name);
+    copy->description = g_strdup (port->description);
+    copy->priority    = port->priority;
+    copy->available   = port->available;
+
+    return copy;
+}
+
+static void
+sink_port_free (pa_sink_port_info *port)
+{
+    g_free ((gchar *) port->name);
+    g_free ((gchar *) port->description);
+
+    g_slice_free (pa_sink_port_info, port);
+}
+
+static pa_source_port_info *
+source_port_copy (const pa_source_port_info *port)
+{
+    pa_source_port_info *copy = g_slice_new0 (pa_source_port_info);
+
+    copy->name        = g_strdup (port->name);
+    copy->description = g_strdup (port->description);
+    copy->priority    = port->priority;
+    copy->available   = port->available;
+
+    return copy;
+}
+
+static void
+source_port_free (pa_source_port_info *port)
+{
+    g_free ((gchar *) port->name);
+    g_free ((gchar *) port->description);
+
+    g_slice_free (pa_source_port_info, port);
+}
+
+pa_server_info *
+pulse_server_info_copy (const pa_server_info *info)
+{
+    pa_server_info *copy;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_server_info);
+    copy->user_name           = g_strdup (info->user_name);
+    copy->host_name           = g_strdup (info->host_name);
+    copy->server_version      = g_strdup (info->server_version);
+    copy->server_name         = g_strdup (info->server_name);
+    copy->sample_spec         = info->sample_spec;
+    copy->default_sink_name   = g_strdup (info->default_sink_name);
+    copy->default_source_name = g_strdup (info->default_source_name);
+    copy->cookie              = info->cookie;
+    copy->channel_map         = info->channel_map;
+
+    return copy;
+}
+
+void
+pulse_server_info_free (pa_server_info *info)
+{
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->user_name);
+    g_free ((gchar *) info->host_name);
+    g_free ((gchar *) info->server_version);
+    g_free ((gchar *) info->server_name);
+    g_free ((gchar *) info->default_sink_name);
+    g_free ((gchar *) info->default_source_name);
+
+    g_slice_free (pa_server_info, info);
+}
+
+pa_card_info *
+pulse_card_info_copy (const pa_card_info *info)
+{
+    pa_card_info *copy;
+    guint32       i;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_card_info);
+    copy->index        = info->index;
+    copy->name         = g_strdup (info->name);
+    copy->owner_module = info->owner_module;
+    copy->driver       = g_strdup (info->driver);
+
+    if (info->proplist != NULL)
+        copy->proplist = pa_proplist_copy (info->proplist);
+
+    /* Both arrays are NULL-terminated, the active profile points into the
+     * copied array */
+    if (info->profiles2 != NULL) {
+        copy->n_profiles = info->n_profiles;
+        copy->profiles2  = g_new0 (pa_card_profile_info2 *, info->n_profiles + 1);
+
+        for (i = 0; i < info->n_profiles; i++) {
+            copy->profiles2[i] = card_profile_copy (info->profiles2[i]);
+
+            if (info->profiles2[i] == info->active_profile2)
+                copy->active_profile2 = copy->profiles2[i];
+        }
+    }
+
+    if (info->ports != NULL) {
+        copy->n_ports = info->n_ports;
+        copy->ports   = g_new0 (pa_card_port_info *, info->n_ports + 1);
+
+        for (i = 0; i < info->n_ports; i++)
+            copy->ports[i] = card_port_copy (info->ports[i]);
+    }
+
+    return copy;
+}
+
+void
+pulse_card_info_free (pa_card_info *info)
+{
+    guint32 i;
+
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->driver);
+
+    if (info->proplist != NULL)
+        pa_proplist_free (info->proplist);
+
+    if (info->profiles2 != NULL) {
+        for (i = 0; i < info->n_profiles; i++)
+            card_profile_free (info->profiles2[i]);
+
+        g_free (info->profiles2);
+    }
+
+    if (info->ports != NULL) {
+        for (i = 0; i < info->n_ports; i++)
+            card_port_free (info->ports[i]);
+
+        g_free (info->ports);
+    }
+
+    g_slice_free (pa_card_info, info);
+}
+
+pa_sink_info *
+pulse_sink_info_copy (const pa_sink_info *info)
+{
+    pa_sink_info *copy;
+    guint32       i;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_sink_info);
+    copy->name                = g_strdup (info->name);
+    copy->index               = info->index;
+    copy->description         = g_strdup (info->description);
+    copy->sample_spec         = info->sample_spec;
+    copy->channel_map         = info->channel_map;
+    copy->owner_module        = info->owner_module;
+    copy->volume              = info->volume;
+    copy->mute                = info->mute;
+    copy->monitor_source      = info->monitor_source;
+    copy->monitor_source_name = g_strdup (info->monitor_source_name);
+    copy->latency             = info->latency;
+    copy->driver              = g_strdup (info->driver);
+    copy->flags               = info->flags;
+    copy->configured_latency  = info->configured_latency;
+    copy->base_volume         = info->base_volume;
+    copy->state               = info->state;
+    copy->n_volume_steps      = info->n_volume_steps;
+    copy->card                = info->card;
+
+    if (info->proplist != NULL)
+        copy->proplist = pa_proplist_copy (info->proplist);
+
+    if (info->ports != NULL) {
+        copy->n_ports = info->n_ports;
+        copy->ports   = g_new0 (pa_sink_port_info *, info->n_ports + 1);
+
+        for (i = 0; i < info->n_ports; i++) {
+            copy->ports[i] = sink_port_copy (info->ports[i]);
+
+            if (info->ports[i] == info->active_port)
+                copy->active_port = copy->ports[i];
+        }
+    }
+
+    return copy;
+}
+
+void
+pulse_sink_info_free (pa_sink_info *info)
+{
+    guint32 i;
+
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->description);
+    g_free ((gchar *) info->monitor_source_name);
+    g_free ((gchar *) info->driver);
+
+    if (info->proplist != NULL)
+        pa_proplist_free (info->proplist);
+
+    if (info->ports != NULL) {
+        for (i = 0; i < info->n_ports; i++)
+            sink_port_free (info->ports[i]);
+
+        g_free (info->ports);
+    }
+
+    g_slice_free (pa_sink_info, info);
+}
+
+pa_source_info *
+pulse_source_info_copy (const pa_source_info *info)
+{
+    pa_source_info *copy;
+    guint32         i;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_source_info);
+    copy->name                 = g_strdup (info->name);
+    copy->index                = info->index;
+    copy->description          = g_strdup (info->description);
+    copy->sample_spec          = info->sample_spec;
+    copy->channel_map          = info->channel_map;
+    copy->owner_module         = info->owner_module;
+    copy->volume               = info->volume;
+    copy->mute                 = info->mute;
+    copy->monitor_of_sink      = info->monitor_of_sink;
+    copy->monitor_of_sink_name = g_strdup (info->monitor_of_sink_name);
+    copy->latency              = info->latency;
+    copy->driver               = g_strdup (info->driver);
+    copy->flags                = info->flags;
+    copy->configured_latency   = info->configured_latency;
+    copy->base_volume          = info->base_volume;
+    copy->state                = info->state;
+    copy->n_volume_steps       = info->n_volume_steps;
+    copy->card                 = info->card;
+
+    if (info->proplist != NULL)
+        copy->proplist = pa_proplist_copy (info->proplist);
+
+    if (info->ports != NULL) {
+        copy->n_ports = info->n_ports;
+        copy->ports   = g_new0 (pa_source_port_info *, info->n_ports + 1);
+
+        for (i = 0; i < info->n_ports; i++) {
+            copy->ports[i] = source_port_copy (info->ports[i]);
+
+            if (info->ports[i] == info->active_port)
+                copy->active_port = copy->ports[i];
+        }
+    }
+
+    return copy;
+}
+
+void
+pulse_source_info_free (pa_source_info *info)
+{
+    guint32 i;
+
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->description);
+    g_free ((gchar *) info->monitor_of_sink_name);
+    g_free ((gchar *) info->driver);
+
+    if (info->proplist != NULL)
+        pa_proplist_free (info->proplist);
+
+    if (info->ports != NULL) {
+        for (i = 0; i < info->n_ports; i++)
+            source_port_free (info->ports[i]);
+
+        g_free (info->ports);
+    }
+
+    g_slice_free (pa_source_info, info);
+}
+
+pa_sink_input_info *
+pulse_sink_input_info_copy (const pa_sink_input_info *info)
+{
+    pa_sink_input_info *copy;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_sink_input_info);
+    copy->index           = info->index;
+    copy->name            = g_strdup (info->name);
+    copy->owner_module    = info->owner_module;
+    copy->client          = info->client;
+    copy->sink            = info->sink;
+    copy->sample_spec     = info->sample_spec;
+    copy->channel_map     = info->channel_map;
+    copy->volume          = info->volume;
+    copy->buffer_usec     = info->buffer_usec;
+    copy->sink_usec       = info->sink_usec;
+    copy->resample_method = g_strdup (info->resample_method);
+    copy->driver          = g_strdup (info->driver);
+    copy->mute            = info->mute;
+    copy->corked          = info->corked;
+    copy->has_volume      = info->has_volume;
+    copy->volume_writable = info->volume_writable;
+
+    if (info->proplist != NULL)
+        copy->proplist = pa_proplist_copy (info->proplist);
+
+    return copy;
+}
+
+void
+pulse_sink_input_info_free (pa_sink_input_info *info)
+{
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->resample_method);
+    g_free ((gchar *) info->driver);
+
+    if (info->proplist != NULL)
+        pa_proplist_free (info->proplist);
+
+    g_slice_free (pa_sink_input_info, info);
+}
+
+pa_source_output_info *
+pulse_source_output_info_copy (const pa_source_output_info *info)
+{
+    pa_source_output_info *copy;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_source_output_info);
+    copy->index           = info->index;
+    copy->name            = g_strdup (info->name);
+    copy->owner_module    = info->owner_module;
+    copy->client          = info->client;
+    copy->source          = info->source;
+    copy->sample_spec     = info->sample_spec;
+    copy->channel_map     = info->channel_map;
+    copy->buffer_usec     = info->buffer_usec;
+    copy->source_usec     = info->source_usec;
+    copy->resample_method = g_strdup (info->resample_method);
+    copy->driver          = g_strdup (info->driver);
+    copy->corked          = info->corked;
+    copy->volume          = info->volume;
+    copy->mute            = info->mute;
+    copy->has_volume      = info->has_volume;
+    copy->volume_writable = info->volume_writable;
+
+    if (info->proplist != NULL)
+        copy->proplist = pa_proplist_copy (info->proplist);
+
+    return copy;
+}
+
+void
+pulse_source_output_info_free (pa_source_output_info *info)
+{
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->resample_method);
+    g_free ((gchar *) info->driver);
+
+    if (info->proplist != NULL)
+        pa_proplist_free (info->proplist);
+
+    g_slice_free (pa_source_output_info, info);
+}
+
+pa_ext_stream_restore_info *
+pulse_ext_stream_info_copy (const pa_ext_stream_restore_info *info)
+{
+    pa_ext_stream_restore_info *copy;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    copy = g_slice_new0 (pa_ext_stream_restore_info);
+    copy->name        = g_strdup (info->name);
+    copy->channel_map = info->channel_map;
+    copy->volume      = info->volume;
+    copy->device      = g_strdup (info->device);
+    copy->mute        = info->mute;
+
+    return copy;
+}
+
+void
+pulse_ext_stream_info_free (pa_ext_stream_restore_info *info)
+{
+    if (info == NULL)
+        return;
+
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->device);
+
+    g_slice_free (pa_ext_stream_restore_info, info);
+}
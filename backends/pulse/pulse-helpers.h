@@ -22,6 +22,7 @@
 #include <libcafemixer/cafemixer.h>
 
 #include <pulse/pulseaudio.h>
+#include <pulse/ext-stream-restore.h>
 
 G_BEGIN_DECLS
 
@@ -30,6 +31,27 @@ extern const pa_channel_position_t      pulse_channel_map_to[CAFE_MIXER_CHANNEL_
 
 CafeMixerStreamControlMediaRole pulse_convert_media_role_name (const gchar *name);
 
+pa_server_info *             pulse_server_info_copy        (const pa_server_info             *info);
+void                         pulse_server_info_free        (pa_server_info                   *info);
+
+pa_card_info *               pulse_card_info_copy          (const pa_card_info               *info);
+void                         pulse_card_info_free          (pa_card_info                     *info);
+
+pa_sink_info *               pulse_sink_info_copy          (const pa_sink_info               *info);
+void                         pulse_sink_info_free          (pa_sink_info                     *info);
+
+pa_source_info *             pulse_source_info_copy        (const pa_source_info             *info);
+void                         pulse_source_info_free        (pa_source_info                   *info);
+
+pa_sink_input_info *         pulse_sink_input_info_copy    (const pa_sink_input_info         *info);
+void                         pulse_sink_input_info_free    (pa_sink_input_info               *info);
+
+pa_source_output_info *      pulse_source_output_info_copy (const pa_source_output_info      *info);
+void                         pulse_source_output_info_free (pa_source_output_info            *info);
+
+pa_ext_stream_restore_info * pulse_ext_stream_info_copy    (const pa_ext_stream_restore_info *info);
+void                         pulse_ext_stream_info_free    (pa_ext_stream_restore_info       *info);
+
 G_END_DECLS
 
 #endif /* PULSE_HELPERS_H */
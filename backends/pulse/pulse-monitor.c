@@ -20,17 +20,23 @@
 #include <glib-object.h>
 
 #include <pulse/pulseaudio.h>
+#include <pulse/thread-mainloop.h>
 
 #include "pulse-monitor.h"
 
 struct _PulseMonitorPrivate
 {
-    pa_context  *context;
-    pa_proplist *proplist;
-    pa_stream   *stream;
-    guint32      index_source;
-    guint32      index_sink_input;
-    gboolean     enabled;
+    PulseConnection      *connection;
+    pa_context           *context;
+    pa_proplist          *proplist;
+    pa_stream            *stream;
+    pa_threaded_mainloop *mainloop;
+    GMainContext         *owner;
+    gdouble               value;
+    GSource              *value_source;
+    guint32               index_source;
+    guint32               index_sink_input;
+    gboolean              enabled;
 };
 
 enum {
@@ -59,15 +65,21 @@ static void pulse_monitor_set_property (GObject           *object,
                                         const GValue      *value,
                                         GParamSpec        *pspec);
 
+static void pulse_monitor_dispose      (GObject           *object);
 static void pulse_monitor_finalize     (GObject           *object);
 
 G_DEFINE_TYPE_WITH_PRIVATE (PulseMonitor, pulse_monitor, G_TYPE_OBJECT);
 
-static gboolean stream_connect (PulseMonitor *monitor);
+static gboolean stream_connect    (PulseMonitor      *monitor);
 
-static void     stream_read_cb (pa_stream    *stream,
-                                size_t        length,
-                                void         *userdata);
+static void     stream_read_cb    (pa_stream         *stream,
+                                   size_t             length,
+                                   void              *userdata);
+
+static void     monitor_lock      (PulseMonitor      *monitor);
+static void     monitor_unlock    (PulseMonitor      *monitor);
+
+static gboolean emit_value_cb     (PulseMonitor      *monitor);
 
 static void
 pulse_monitor_class_init (PulseMonitorClass *klass)
@@ -75,6 +87,7 @@ pulse_monitor_class_init (PulseMonitorClass *klass)
     GObjectClass *object_class;
 
     object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose      = pulse_monitor_dispose;
     object_class->finalize     = pulse_monitor_finalize;
     object_class->get_property = pulse_monitor_get_property;
     object_class->set_property = pulse_monitor_set_property;
@@ -180,7 +193,7 @@ pulse_monitor_init (PulseMonitor *monitor)
 }
 
 static void
-pulse_monitor_finalize (GObject *object)
+pulse_monitor_dispose (GObject *object)
 {
     PulseMonitor *monitor;
 
@@ -188,34 +201,72 @@ pulse_monitor_finalize (GObject *object)
 
     /* The pulse stream may exist if the monitor is running */
     if (monitor->priv->stream != NULL) {
+        monitor_lock (monitor);
+
         pa_stream_disconnect (monitor->priv->stream);
         pa_stream_unref (monitor->priv->stream);
+
+        monitor->priv->stream = NULL;
+
+        monitor_unlock (monitor);
     }
 
+    G_OBJECT_CLASS (pulse_monitor_parent_class)->dispose (object);
+}
+
+static void
+pulse_monitor_finalize (GObject *object)
+{
+    PulseMonitor *monitor;
+
+    monitor = PULSE_MONITOR (object);
+
+    monitor_lock (monitor);
     pa_context_unref (monitor->priv->context);
+    monitor_unlock (monitor);
+
     pa_proplist_free (monitor->priv->proplist);
 
+    if (monitor->priv->owner != NULL)
+        g_main_context_unref (monitor->priv->owner);
+
+    /* The connection owns the libpulse thread and its lock */
+    g_object_unref (monitor->priv->connection);
+
     G_OBJECT_CLASS (pulse_monitor_parent_class)->finalize (object);
 }
 
 PulseMonitor *
-pulse_monitor_new (pa_context  *context,
-                   pa_proplist *proplist,
-                   guint32      index_source,
-                   guint32      index_sink_input)
+pulse_monitor_new (PulseConnection      *connection,
+                   pa_context           *context,
+                   pa_proplist          *proplist,
+                   pa_threaded_mainloop *mainloop,
+                   guint32               index_source,
+                   guint32               index_sink_input)
 {
     PulseMonitor *monitor;
 
-    g_return_val_if_fail (context  != NULL, NULL);
-    g_return_val_if_fail (proplist != NULL, NULL);
+    g_return_val_if_fail (connection != NULL, NULL);
+    g_return_val_if_fail (context    != NULL, NULL);
+    g_return_val_if_fail (proplist   != NULL, NULL);
 
     monitor = g_object_new (PULSE_TYPE_MONITOR,
                             "index-source", index_source,
                             "index-sink-input", index_sink_input,
                             NULL);
 
-    monitor->priv->context  = pa_context_ref (context);
-    monitor->priv->proplist = pa_proplist_copy (proplist);
+    /* Keep the connection, and so the main loop, alive for as long as the
+     * monitor may use it */
+    monitor->priv->connection = g_object_ref (connection);
+    monitor->priv->context    = pa_context_ref (context);
+    monitor->priv->proplist   = pa_proplist_copy (proplist);
+
+    /* When libpulse runs in its own thread, the values are read there and
+     * passed to the main context of the caller */
+    if (mainloop != NULL) {
+        monitor->priv->mainloop = mainloop;
+        monitor->priv->owner    = g_main_context_ref_thread_default ();
+    }
 
     return monitor;
 }
@@ -237,13 +288,17 @@ pulse_monitor_set_enabled (PulseMonitor *monitor, gboolean enabled)
         return TRUE;
 
     if (enabled) {
+        monitor_lock (monitor);
         monitor->priv->enabled = stream_connect (monitor);
+        monitor_unlock (monitor);
 
         if (monitor->priv->enabled == FALSE)
             return FALSE;
     } else {
+        monitor_lock (monitor);
         pa_stream_disconnect (monitor->priv->stream);
         pa_stream_unref (monitor->priv->stream);
+        monitor_unlock (monitor);
 
         monitor->priv->stream = NULL;
         monitor->priv->enabled = FALSE;
@@ -330,12 +385,31 @@ stream_read_cb (pa_stream *stream, size_t length, void *userdata)
         return;
 
     if (data != NULL) {
-        gdouble v = ((const gfloat *) data)[length / sizeof (gfloat) - 1];
-
-        g_signal_emit (G_OBJECT (userdata),
-                       signals[VALUE],
-                       0,
-                       CLAMP (v, 0, 1));
+        PulseMonitor *monitor = PULSE_MONITOR (userdata);
+        gdouble       v = ((const gfloat *) data)[length / sizeof (gfloat) - 1];
+
+        if (monitor->priv->mainloop != NULL) {
+            /* Only the latest value is passed to the main context, values
+             * read before it gets to emit them are overwritten; this runs
+             * with the lock held */
+            monitor->priv->value = CLAMP (v, 0, 1);
+
+            if (monitor->priv->value_source == NULL) {
+                GSource *source = g_idle_source_new ();
+
+                g_source_set_callback (source,
+                                       (GSourceFunc) emit_value_cb,
+                                       g_object_ref (monitor),
+                                       g_object_unref);
+                g_source_attach (source, monitor->priv->owner);
+
+                monitor->priv->value_source = source;
+            }
+        } else
+            g_signal_emit (G_OBJECT (monitor),
+                           signals[VALUE],
+                           0,
+                           CLAMP (v, 0, 1));
     }
 
     /* pa_stream_drop() should not be called if the buffer is empty, but it
@@ -343,3 +417,38 @@ stream_read_cb (pa_stream *stream, size_t length, void *userdata)
     if (length > 0)
         pa_stream_drop (stream);
 }
+
+static void
+monitor_lock (PulseMonitor *monitor)
+{
+    if (monitor->priv->mainloop != NULL)
+        pa_threaded_mainloop_lock (monitor->priv->mainloop);
+}
+
+static void
+monitor_unlock (PulseMonitor *monitor)
+{
+    if (monitor->priv->mainloop != NULL)
+        pa_threaded_mainloop_unlock (monitor->priv->mainloop);
+}
+
+static gboolean
+emit_value_cb (PulseMonitor *monitor)
+{
+    gdouble value;
+
+    monitor_lock (monitor);
+    value = monitor->priv->value;
+
+    g_clear_pointer (&monitor->priv->value_source, g_source_unref);
+    monitor_unlock (monitor);
+
+    /* Drop values which arrive after the monitor has been disabled */
+    if (monitor->priv->enabled == TRUE)
+        g_signal_emit (G_OBJECT (monitor),
+                       signals[VALUE],
+                       0,
+                       value);
+
+    return G_SOURCE_REMOVE;
+}
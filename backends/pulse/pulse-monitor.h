@@ -62,10 +62,12 @@ struct _PulseMonitorClass
 
 GType         pulse_monitor_get_type     (void) G_GNUC_CONST;
 
-PulseMonitor *pulse_monitor_new          (pa_context   *context,
-                                          pa_proplist  *proplist,
-                                          guint32       index_source,
-                                          guint32       index_sink_input);
+PulseMonitor *pulse_monitor_new          (PulseConnection      *connection,
+                                          pa_context           *context,
+                                          pa_proplist          *proplist,
+                                          pa_threaded_mainloop *mainloop,
+                                          guint32               index_source,
+                                          guint32               index_sink_input);
 
 gboolean      pulse_monitor_get_enabled  (PulseMonitor *monitor);
 gboolean      pulse_monitor_set_enabled  (PulseMonitor *monitor,
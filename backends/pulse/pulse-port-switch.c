@@ -43,8 +43,6 @@ static const GList *pulse_port_switch_list_options      (CafeMixerSwitch       *
 
 static gint         compare_ports                       (gconstpointer          a,
                                                          gconstpointer          b);
-static gint         compare_port_name                   (gconstpointer          a,
-                                                         gconstpointer          b);
 
 static void
 pulse_port_switch_class_init (PulsePortSwitchClass *klass)
@@ -97,6 +95,9 @@ pulse_port_switch_add_port (PulsePortSwitch *swtch, PulsePort *port)
     swtch->priv->ports = g_list_insert_sorted (swtch->priv->ports,
                                                port,
                                                compare_ports);
+
+    _cafe_mixer_switch_index_option (CAFE_MIXER_SWITCH (swtch),
+                                     CAFE_MIXER_SWITCH_OPTION (port));
 }
 
 void
@@ -112,17 +113,17 @@ pulse_port_switch_set_active_port (PulsePortSwitch *swtch, PulsePort *port)
 void
 pulse_port_switch_set_active_port_by_name (PulsePortSwitch *swtch, const gchar *name)
 {
-    GList *item;
+    CafeMixerSwitchOption *option;
 
     g_return_if_fail (PULSE_IS_PORT_SWITCH (swtch));
     g_return_if_fail (name != NULL);
 
-    item = g_list_find_custom (swtch->priv->ports, name, compare_port_name);
-    if (G_UNLIKELY (item == NULL)) {
+    option = cafe_mixer_switch_get_option (CAFE_MIXER_SWITCH (swtch), name);
+    if (G_UNLIKELY (option == NULL)) {
         g_debug ("Invalid switch port name %s", name);
         return;
     }
-    pulse_port_switch_set_active_port (swtch, PULSE_PORT (item->data));
+    pulse_port_switch_set_active_port (swtch, PULSE_PORT (option));
 }
 
 static gboolean
@@ -153,12 +154,3 @@ compare_ports (gconstpointer a, gconstpointer b)
     return pulse_port_get_priority (PULSE_PORT (b)) -
            pulse_port_get_priority (PULSE_PORT (a));
 }
-
-static gint
-compare_port_name (gconstpointer a, gconstpointer b)
-{
-    PulsePort   *port = PULSE_PORT (a);
-    const gchar *name = (const gchar *) b;
-
-    return strcmp (pulse_port_get_name (port), name);
-}
@@ -38,7 +38,7 @@ struct _PulseSinkPrivate
 {
     guint32           monitor;
     GHashTable       *inputs;
-    GList            *inputs_list;
+    GQueue            controls;
     PulsePortSwitch  *pswitch;
     GList            *pswitch_list;
     PulseSinkControl *control;
@@ -52,8 +52,6 @@ G_DEFINE_TYPE_WITH_PRIVATE (PulseSink, pulse_sink, PULSE_TYPE_STREAM);
 static const GList *pulse_sink_list_controls (CafeMixerStream *mms);
 static const GList *pulse_sink_list_switches (CafeMixerStream *mms);
 
-static void         free_list_controls       (PulseSink       *sink);
-
 static void
 pulse_sink_class_init (PulseSinkClass *klass)
 {
@@ -74,10 +72,11 @@ pulse_sink_init (PulseSink *sink)
 {
     sink->priv = pulse_sink_get_instance_private (sink);
 
-    sink->priv->inputs = g_hash_table_new_full (g_direct_hash,
-                                                g_direct_equal,
-                                                NULL,
-                                                g_object_unref);
+    /* Maps input indices to links of the control queue, the queue owns
+     * the controls */
+    sink->priv->inputs = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    g_queue_init (&sink->priv->controls);
 
     sink->priv->monitor = PA_INVALID_INDEX;
 }
@@ -94,7 +93,10 @@ pulse_sink_dispose (GObject *object)
     g_clear_object (&sink->priv->control);
     g_clear_object (&sink->priv->pswitch);
 
-    free_list_controls (sink);
+    if (sink->priv->controls.head != NULL) {
+        g_list_free_full (sink->priv->controls.head, g_object_unref);
+        g_queue_init (&sink->priv->controls);
+    }
 
     if (sink->priv->pswitch_list != NULL) {
         g_list_free (sink->priv->pswitch_list);
@@ -137,6 +139,12 @@ pulse_sink_new (PulseConnection    *connection,
 
     sink->priv->control = pulse_sink_control_new (connection, info, sink);
 
+    /* The main control always stays at the head of the control list */
+    g_queue_push_head (&sink->priv->controls, g_object_ref (sink->priv->control));
+
+    _cafe_mixer_stream_index_control (CAFE_MIXER_STREAM (sink),
+                                      CAFE_MIXER_STREAM_CONTROL (sink->priv->control));
+
     if (info->n_ports > 0) {
         pa_sink_port_info **ports = info->ports;
 
@@ -169,6 +177,9 @@ pulse_sink_new (PulseConnection    *connection,
         }
         sink->priv->pswitch_list = g_list_prepend (NULL, sink->priv->pswitch);
 
+        _cafe_mixer_stream_index_switch (CAFE_MIXER_STREAM (sink),
+                                         CAFE_MIXER_STREAM_SWITCH (sink->priv->pswitch));
+
         g_debug ("Created port list for sink %s", info->name);
     }
 
@@ -183,13 +194,14 @@ gboolean
 pulse_sink_add_input (PulseSink *sink, const pa_sink_input_info *info)
 {
     PulseSinkInput *input;
+    GList          *link;
 
     g_return_val_if_fail (PULSE_IS_SINK (sink), FALSE);
     g_return_val_if_fail (info != NULL, FALSE);
 
     /* This function is used for both creating and refreshing sink inputs */
-    input = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (info->index));
-    if (input == NULL) {
+    link = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (info->index));
+    if (link == NULL) {
         const gchar *name;
         PulseConnection *connection;
 
@@ -198,11 +210,15 @@ pulse_sink_add_input (PulseSink *sink, const pa_sink_input_info *info)
                                       info,
                                       sink);
 
+        /* Takes the reference of the new input */
+        g_queue_push_tail (&sink->priv->controls, input);
+
         g_hash_table_insert (sink->priv->inputs,
                              GUINT_TO_POINTER (info->index),
-                             input);
+                             sink->priv->controls.tail);
 
-        free_list_controls (sink);
+        _cafe_mixer_stream_index_control (CAFE_MIXER_STREAM (sink),
+                                          CAFE_MIXER_STREAM_CONTROL (input));
 
         name = cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (input));
         g_signal_emit_by_name (G_OBJECT (sink),
@@ -211,7 +227,7 @@ pulse_sink_add_input (PulseSink *sink, const pa_sink_input_info *info)
         return TRUE;
     }
 
-    pulse_sink_input_update (input, info);
+    pulse_sink_input_update (PULSE_SINK_INPUT (link->data), info);
     return FALSE;
 }
 
@@ -219,23 +235,30 @@ void
 pulse_sink_remove_input (PulseSink *sink, guint32 index)
 {
     PulseSinkInput *input;
+    GList          *link;
     gchar          *name;
 
     g_return_if_fail (PULSE_IS_SINK (sink));
 
-    input = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (index));
-    if (G_UNLIKELY (input == NULL))
+    link = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (index));
+    if (G_UNLIKELY (link == NULL))
         return;
 
+    input = PULSE_SINK_INPUT (link->data);
+
     name = g_strdup (cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (input)));
 
+    _cafe_mixer_stream_unindex_control (CAFE_MIXER_STREAM (sink),
+                                        CAFE_MIXER_STREAM_CONTROL (input));
+
     g_hash_table_remove (sink->priv->inputs, GUINT_TO_POINTER (index));
+    g_queue_delete_link (&sink->priv->controls, link);
 
-    free_list_controls (sink);
     g_signal_emit_by_name (G_OBJECT (sink),
                            "control-removed",
                            name);
     g_free (name);
+    g_object_unref (input);
 }
 
 void
@@ -272,15 +295,9 @@ pulse_sink_list_controls (CafeMixerStream *mms)
 
     sink = PULSE_SINK (mms);
 
-    if (sink->priv->inputs_list == NULL) {
-        sink->priv->inputs_list = g_hash_table_get_values (sink->priv->inputs);
-        if (sink->priv->inputs_list != NULL)
-            g_list_foreach (sink->priv->inputs_list, (GFunc) g_object_ref, NULL);
-
-        sink->priv->inputs_list = g_list_prepend (sink->priv->inputs_list,
-                                                  g_object_ref (sink->priv->control));
-    }
-    return sink->priv->inputs_list;
+    /* The queue keeps the main control first followed by the inputs in the
+     * order they were added */
+    return sink->priv->controls.head;
 }
 
 static const GList *
@@ -290,14 +307,3 @@ pulse_sink_list_switches (CafeMixerStream *mms)
 
     return PULSE_SINK (mms)->priv->pswitch_list;
 }
-
-static void
-free_list_controls (PulseSink *sink)
-{
-    if (sink->priv->inputs_list == NULL)
-        return;
-
-    g_list_free_full (sink->priv->inputs_list, g_object_unref);
-
-    sink->priv->inputs_list = NULL;
-}
@@ -37,7 +37,7 @@
 struct _PulseSourcePrivate
 {
     GHashTable         *outputs;
-    GList              *outputs_list;
+    GQueue              controls;
     PulsePortSwitch    *pswitch;
     GList              *pswitch_list;
     PulseSourceControl *control;
@@ -51,8 +51,6 @@ G_DEFINE_TYPE_WITH_PRIVATE (PulseSource, pulse_source, PULSE_TYPE_STREAM);
 static const GList *pulse_source_list_controls (CafeMixerStream *mms);
 static const GList *pulse_source_list_switches (CafeMixerStream *mms);
 
-static void         free_list_controls         (PulseSource     *source);
-
 static void
 pulse_source_class_init (PulseSourceClass *klass)
 {
@@ -73,10 +71,11 @@ pulse_source_init (PulseSource *source)
 {
     source->priv = pulse_source_get_instance_private (source);
 
-    source->priv->outputs = g_hash_table_new_full (g_direct_hash,
-                                                   g_direct_equal,
-                                                   NULL,
-                                                   g_object_unref);
+    /* Maps output indices to links of the control queue, the queue owns
+     * the controls */
+    source->priv->outputs = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    g_queue_init (&source->priv->controls);
 }
 
 static void
@@ -91,7 +90,10 @@ pulse_source_dispose (GObject *object)
     g_clear_object (&source->priv->control);
     g_clear_object (&source->priv->pswitch);
 
-    free_list_controls (source);
+    if (source->priv->controls.head != NULL) {
+        g_list_free_full (source->priv->controls.head, g_object_unref);
+        g_queue_init (&source->priv->controls);
+    }
 
     if (source->priv->pswitch_list != NULL) {
         g_list_free (source->priv->pswitch_list);
@@ -134,6 +136,12 @@ pulse_source_new (PulseConnection      *connection,
 
     source->priv->control = pulse_source_control_new (connection, info, source);
 
+    /* The main control always stays at the head of the control list */
+    g_queue_push_head (&source->priv->controls, g_object_ref (source->priv->control));
+
+    _cafe_mixer_stream_index_control (CAFE_MIXER_STREAM (source),
+                                      CAFE_MIXER_STREAM_CONTROL (source->priv->control));
+
     if (info->n_ports > 0) {
         pa_source_port_info **ports = info->ports;
 
@@ -166,6 +174,9 @@ pulse_source_new (PulseConnection      *connection,
         }
         source->priv->pswitch_list = g_list_prepend (NULL, source->priv->pswitch);
 
+        _cafe_mixer_stream_index_switch (CAFE_MIXER_STREAM (source),
+                                         CAFE_MIXER_STREAM_SWITCH (source->priv->pswitch));
+
         g_debug ("Created port list for source %s", info->name);
     }
 
@@ -180,13 +191,14 @@ gboolean
 pulse_source_add_output (PulseSource *source, const pa_source_output_info *info)
 {
     PulseSourceOutput *output;
+    GList             *link;
 
     g_return_val_if_fail (PULSE_IS_SOURCE (source), FALSE);
     g_return_val_if_fail (info != NULL, FALSE);
 
     /* This function is used for both creating and refreshing source outputs */
-    output = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (info->index));
-    if (output == NULL) {
+    link = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (info->index));
+    if (link == NULL) {
         const gchar *name;
         PulseConnection *connection;
 
@@ -194,11 +206,15 @@ pulse_source_add_output (PulseSource *source, const pa_source_output_info *info)
         output = pulse_source_output_new (connection,
                                           info,
                                           source);
+        /* Takes the reference of the new output */
+        g_queue_push_tail (&source->priv->controls, output);
+
         g_hash_table_insert (source->priv->outputs,
                              GUINT_TO_POINTER (info->index),
-                             output);
+                             source->priv->controls.tail);
 
-        free_list_controls (source);
+        _cafe_mixer_stream_index_control (CAFE_MIXER_STREAM (source),
+                                          CAFE_MIXER_STREAM_CONTROL (output));
 
         name = cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (output));
         g_signal_emit_by_name (G_OBJECT (source),
@@ -207,7 +223,7 @@ pulse_source_add_output (PulseSource *source, const pa_source_output_info *info)
         return TRUE;
     }
 
-    pulse_source_output_update (output, info);
+    pulse_source_output_update (PULSE_SOURCE_OUTPUT (link->data), info);
     return FALSE;
 }
 
@@ -215,23 +231,30 @@ void
 pulse_source_remove_output (PulseSource *source, guint32 index)
 {
     PulseSourceOutput *output;
+    GList             *link;
     gchar             *name;
 
     g_return_if_fail (PULSE_IS_SOURCE (source));
 
-    output = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (index));
-    if (G_UNLIKELY (output == NULL))
+    link = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (index));
+    if (G_UNLIKELY (link == NULL))
         return;
 
+    output = PULSE_SOURCE_OUTPUT (link->data);
+
     name = g_strdup (cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (output)));
 
+    _cafe_mixer_stream_unindex_control (CAFE_MIXER_STREAM (source),
+                                        CAFE_MIXER_STREAM_CONTROL (output));
+
     g_hash_table_remove (source->priv->outputs, GUINT_TO_POINTER (index));
+    g_queue_delete_link (&source->priv->controls, link);
 
-    free_list_controls (source);
     g_signal_emit_by_name (G_OBJECT (source),
                            "control-removed",
                            name);
     g_free (name);
+    g_object_unref (output);
 }
 
 void
@@ -259,15 +282,9 @@ pulse_source_list_controls (CafeMixerStream *mms)
 
     source = PULSE_SOURCE (mms);
 
-    if (source->priv->outputs_list == NULL) {
-        source->priv->outputs_list = g_hash_table_get_values (source->priv->outputs);
-        if (source->priv->outputs_list != NULL)
-            g_list_foreach (source->priv->outputs_list, (GFunc) g_object_ref, NULL);
-
-        source->priv->outputs_list = g_list_prepend (source->priv->outputs_list,
-                                                     g_object_ref (source->priv->control));
-    }
-    return source->priv->outputs_list;
+    /* The queue keeps the main control first followed by the outputs in the
+     * order they were added */
+    return source->priv->controls.head;
 }
 
 static const GList *
@@ -277,14 +294,3 @@ pulse_source_list_switches (CafeMixerStream *mms)
 
     return PULSE_SOURCE (mms)->priv->pswitch_list;
 }
-
-static void
-free_list_controls (PulseSource *source)
-{
-    if (source->priv->outputs_list == NULL)
-        return;
-
-    g_list_free_full (source->priv->outputs_list, g_object_unref);
-
-    source->priv->outputs_list = NULL;
-}
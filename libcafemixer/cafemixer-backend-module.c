@@ -21,19 +21,17 @@
 
 #include "cafemixer-backend-module.h"
 
-/* Initialize backend */
-typedef void (*BackendInit) (GTypeModule *type_module);
-
-/* Return information about backend */
-typedef const CafeMixerBackendInfo *(*BackendGetInfo) (void);
-
 struct _CafeMixerBackendModulePrivate
 {
-    GModule       *gmodule;
-    gchar         *path;
-    gboolean       loaded;
-    BackendInit    init;
-    BackendGetInfo get_info;
+    GModule                    *gmodule;
+    gchar                      *path;
+    gboolean                    builtin;
+    gboolean                    loaded;
+    gboolean                    used;
+    gboolean                    use_failed;
+    CafeMixerBackendInitFunc    init;
+    CafeMixerBackendGetInfoFunc get_info;
+    CafeMixerBackendInfo       *manifest_info;
 };
 
 enum {
@@ -160,6 +158,11 @@ cafe_mixer_backend_module_finalize (GObject *object)
 
     module = CAFE_MIXER_BACKEND_MODULE (object);
 
+    if (module->priv->manifest_info != NULL) {
+        g_free (module->priv->manifest_info->name);
+        g_slice_free (CafeMixerBackendInfo, module->priv->manifest_info);
+    }
+
     g_free (module->priv->path);
 
     G_OBJECT_CLASS (cafe_mixer_backend_module_parent_class)->finalize (object);
@@ -183,11 +186,105 @@ cafe_mixer_backend_module_new (const gchar *path)
                          NULL);
 }
 
+/**
+ * cafe_mixer_backend_module_new_from_manifest:
+ * @path: path to a backend module
+ * @info: information about the backend read from the module manifest
+ *
+ * Creates a new #CafeMixerBackendModule instance for a module which has not
+ * been loaded yet. Until the module is loaded with
+ * cafe_mixer_backend_module_load(), cafe_mixer_backend_module_get_info()
+ * returns a copy of @info with an invalid #GType.
+ *
+ * Returns: a new #CafeMixerBackendModule instance.
+ */
+CafeMixerBackendModule *
+cafe_mixer_backend_module_new_from_manifest (const gchar                *path,
+                                             const CafeMixerBackendInfo *info)
+{
+    CafeMixerBackendModule *module;
+
+    g_return_val_if_fail (path != NULL, NULL);
+    g_return_val_if_fail (info != NULL, NULL);
+
+    module = cafe_mixer_backend_module_new (path);
+
+    module->priv->manifest_info = g_slice_dup (CafeMixerBackendInfo, info);
+    module->priv->manifest_info->name   = g_strdup (info->name);
+    module->priv->manifest_info->g_type = G_TYPE_INVALID;
+
+    return module;
+}
+
+/**
+ * cafe_mixer_backend_module_new_builtin:
+ * @name: name of the backend module
+ * @init: the backend initialization function
+ * @get_info: the function returning information about the backend
+ *
+ * Creates a new #CafeMixerBackendModule instance for a backend which is
+ * linked into the library. Loading such a module only registers the backend
+ * types, no shared object is opened.
+ *
+ * Returns: a new #CafeMixerBackendModule instance.
+ */
+CafeMixerBackendModule *
+cafe_mixer_backend_module_new_builtin (const gchar                *name,
+                                       CafeMixerBackendInitFunc    init,
+                                       CafeMixerBackendGetInfoFunc get_info)
+{
+    CafeMixerBackendModule *module;
+
+    g_return_val_if_fail (name != NULL, NULL);
+    g_return_val_if_fail (init != NULL, NULL);
+    g_return_val_if_fail (get_info != NULL, NULL);
+
+    module = cafe_mixer_backend_module_new (name);
+
+    module->priv->builtin  = TRUE;
+    module->priv->init     = init;
+    module->priv->get_info = get_info;
+
+    return module;
+}
+
+/**
+ * cafe_mixer_backend_module_load:
+ * @module: a #CafeMixerBackendModule
+ *
+ * Loads the backend module unless it has already been loaded. The module
+ * is never unloaded once this function succeeds.
+ *
+ * Returns: %TRUE on success or %FALSE if the module cannot be loaded.
+ */
+gboolean
+cafe_mixer_backend_module_load (CafeMixerBackendModule *module)
+{
+    g_return_val_if_fail (CAFE_MIXER_IS_BACKEND_MODULE (module), FALSE);
+
+    if (module->priv->used == TRUE)
+        return TRUE;
+
+    /* Do not retry a module which failed, it might have been partially
+     * initialized */
+    if (module->priv->use_failed == TRUE)
+        return FALSE;
+
+    if (g_type_module_use (G_TYPE_MODULE (module)) == FALSE) {
+        module->priv->use_failed = TRUE;
+        return FALSE;
+    }
+
+    module->priv->used = TRUE;
+    return TRUE;
+}
+
 /**
  * cafe_mixer_backend_module_get_info:
  * @module: a #CafeMixerBackendModule
  *
- * Gets information about the loaded backend.
+ * Gets information about the backend. If the module has not been loaded yet,
+ * the information comes from the module manifest and the #GType is invalid.
  *
  * Returns: a #CafeMixerBackendInfo.
  */
@@ -195,9 +292,13 @@ const CafeMixerBackendInfo *
 cafe_mixer_backend_module_get_info (CafeMixerBackendModule *module)
 {
     g_return_val_if_fail (CAFE_MIXER_IS_BACKEND_MODULE (module), NULL);
-    g_return_val_if_fail (module->priv->loaded == TRUE, NULL);
 
-    return module->priv->get_info ();
+    if (module->priv->used == TRUE)
+        return module->priv->get_info ();
+
+    g_return_val_if_fail (module->priv->manifest_info != NULL, NULL);
+
+    return module->priv->manifest_info;
 }
 
 /**
@@ -226,6 +327,21 @@ backend_module_load (GTypeModule *type_module)
     if (module->priv->loaded == TRUE)
         return TRUE;
 
+    if (module->priv->builtin == TRUE) {
+        /* The entry points are known, only the types need to be registered */
+        module->priv->init (type_module);
+        module->priv->loaded = TRUE;
+
+        if (G_UNLIKELY (module->priv->get_info () == NULL)) {
+            g_critical ("Backend module %s does not provide module information",
+                        module->priv->path);
+            return FALSE;
+        }
+
+        g_debug ("Loaded built-in backend module %s", module->priv->path);
+        return TRUE;
+    }
+
     module->priv->gmodule = g_module_open (module->priv->path,
                                            G_MODULE_BIND_LAZY |
                                            G_MODULE_BIND_LOCAL);
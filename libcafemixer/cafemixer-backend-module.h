@@ -65,12 +65,23 @@ struct _CafeMixerBackendInfo
     CafeMixerBackendType  backend_type;
 };
 
-GType                       cafe_mixer_backend_module_get_type (void) G_GNUC_CONST;
+/* Entry points each backend module provides */
+typedef void                        (*CafeMixerBackendInitFunc)    (GTypeModule *type_module);
+typedef const CafeMixerBackendInfo *(*CafeMixerBackendGetInfoFunc) (void);
 
-CafeMixerBackendModule *    cafe_mixer_backend_module_new      (const gchar            *path);
+GType                       cafe_mixer_backend_module_get_type          (void) G_GNUC_CONST;
 
-const CafeMixerBackendInfo *cafe_mixer_backend_module_get_info (CafeMixerBackendModule *module);
-const gchar *               cafe_mixer_backend_module_get_path (CafeMixerBackendModule *module);
+CafeMixerBackendModule *    cafe_mixer_backend_module_new               (const gchar                *path);
+CafeMixerBackendModule *    cafe_mixer_backend_module_new_from_manifest (const gchar                *path,
+                                                                         const CafeMixerBackendInfo *info);
+CafeMixerBackendModule *    cafe_mixer_backend_module_new_builtin       (const gchar                *name,
+                                                                         CafeMixerBackendInitFunc    init,
+                                                                         CafeMixerBackendGetInfoFunc get_info);
+
+gboolean                    cafe_mixer_backend_module_load              (CafeMixerBackendModule     *module);
+
+const CafeMixerBackendInfo *cafe_mixer_backend_module_get_info          (CafeMixerBackendModule     *module);
+const gchar *               cafe_mixer_backend_module_get_path          (CafeMixerBackendModule     *module);
 
 G_END_DECLS
 
@@ -26,14 +26,20 @@
 #include "cafemixer-stream.h"
 #include "cafemixer-stream-control.h"
 #include "cafemixer-stored-control.h"
+#include "cafemixer-private.h"
 
 struct _CafeMixerBackendPrivate
 {
     GHashTable           *devices;
+    GHashTable           *streams;
+    GHashTable           *stored_controls;
     CafeMixerStream      *default_input;
     CafeMixerStream      *default_output;
     CafeMixerState        state;
     CafeMixerBackendFlags flags;
+    guint                 generation;
+    guint                 changes_depth;
+    GHashTable           *frozen_controls;
 };
 
 enum {
@@ -72,15 +78,36 @@ static void cafe_mixer_backend_finalize     (GObject               *object);
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (CafeMixerBackend, cafe_mixer_backend, G_TYPE_OBJECT)
 
-static void device_added          (CafeMixerBackend *backend,
-                                   const gchar      *name);
-static void device_removed        (CafeMixerBackend *backend,
-                                   const gchar      *name);
+static void device_added           (CafeMixerBackend *backend,
+                                    const gchar      *name);
+static void device_removed         (CafeMixerBackend *backend,
+                                    const gchar      *name);
 
-static void device_stream_added   (CafeMixerBackend *backend,
-                                   const gchar      *name);
-static void device_stream_removed (CafeMixerBackend *backend,
-                                   const gchar      *name);
+static void device_stream_added    (CafeMixerDevice  *device,
+                                    const gchar      *name,
+                                    CafeMixerBackend *backend);
+static void device_stream_removed  (CafeMixerDevice  *device,
+                                    const gchar      *name,
+                                    CafeMixerBackend *backend);
+
+static void stream_added           (CafeMixerBackend *backend,
+                                    const gchar      *name);
+static void stream_removed         (CafeMixerBackend *backend,
+                                    const gchar      *name);
+
+static void stored_control_added   (CafeMixerBackend *backend,
+                                    const gchar      *name);
+static void stored_control_removed (CafeMixerBackend *backend,
+                                    const gchar      *name);
+
+static void clear_indexes          (CafeMixerBackend *backend);
+static void next_generation        (CafeMixerBackend *backend);
+
+static void thaw_control           (gpointer          control);
+static void end_changes            (CafeMixerBackend *backend);
+
+/* Backends with uncommitted changes, the most recent one first */
+static GSList *changing_backends = NULL;
 
 static void
 cafe_mixer_backend_class_init (CafeMixerBackendClass *klass)
@@ -249,10 +276,28 @@ cafe_mixer_backend_init (CafeMixerBackend *backend)
 {
     backend->priv = cafe_mixer_backend_get_instance_private (backend);
 
+    /* These hash tables index devices, streams and stored controls by name,
+     * so lookups never need to walk (and possibly rebuild) the backend lists */
     backend->priv->devices = g_hash_table_new_full (g_str_hash,
                                                     g_str_equal,
                                                     g_free,
                                                     g_object_unref);
+    backend->priv->streams = g_hash_table_new_full (g_str_hash,
+                                                    g_str_equal,
+                                                    g_free,
+                                                    g_object_unref);
+    backend->priv->stored_controls = g_hash_table_new_full (g_str_hash,
+                                                            g_str_equal,
+                                                            g_free,
+                                                            g_object_unref);
+
+    backend->priv->frozen_controls = g_hash_table_new_full (g_direct_hash,
+                                                            g_direct_equal,
+                                                            thaw_control,
+                                                            NULL);
+
+    /* Generation 0 is reserved for "not available" */
+    backend->priv->generation = 1;
 
     g_signal_connect (G_OBJECT (backend),
                       "device-added",
@@ -263,6 +308,26 @@ cafe_mixer_backend_init (CafeMixerBackend *backend)
                       "device-removed",
                       G_CALLBACK (device_removed),
                       NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stream-added",
+                      G_CALLBACK (stream_added),
+                      NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stream-removed",
+                      G_CALLBACK (stream_removed),
+                      NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stored-control-added",
+                      G_CALLBACK (stored_control_added),
+                      NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stored-control-removed",
+                      G_CALLBACK (stored_control_removed),
+                      NULL);
 }
 
 static void
@@ -275,7 +340,8 @@ cafe_mixer_backend_dispose (GObject *object)
     g_clear_object (&backend->priv->default_input);
     g_clear_object (&backend->priv->default_output);
 
-    g_hash_table_remove_all (backend->priv->devices);
+    clear_indexes (backend);
+    end_changes (backend);
 
     G_OBJECT_CLASS (cafe_mixer_backend_parent_class)->dispose (object);
 }
@@ -288,6 +354,9 @@ cafe_mixer_backend_finalize (GObject *object)
     backend = CAFE_MIXER_BACKEND (object);
 
     g_hash_table_unref (backend->priv->devices);
+    g_hash_table_unref (backend->priv->streams);
+    g_hash_table_unref (backend->priv->stored_controls);
+    g_hash_table_unref (backend->priv->frozen_controls);
 
     G_OBJECT_CLASS (cafe_mixer_backend_parent_class)->finalize (object);
 }
@@ -351,61 +420,36 @@ cafe_mixer_backend_get_state (CafeMixerBackend *backend)
 CafeMixerDevice *
 cafe_mixer_backend_get_device (CafeMixerBackend *backend, const gchar *name)
 {
-    const GList *list;
-
     g_return_val_if_fail (CAFE_MIXER_IS_BACKEND (backend), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = cafe_mixer_backend_list_devices (backend);
-    while (list != NULL) {
-        CafeMixerDevice *device = CAFE_MIXER_DEVICE (list->data);
-
-        if (strcmp (name, cafe_mixer_device_get_name (device)) == 0)
-            return device;
-
-        list = list->next;
-    }
-    return NULL;
+    return g_hash_table_lookup (backend->priv->devices, name);
 }
 
 CafeMixerStream *
 cafe_mixer_backend_get_stream (CafeMixerBackend *backend, const gchar *name)
 {
-    const GList *list;
-
     g_return_val_if_fail (CAFE_MIXER_IS_BACKEND (backend), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = cafe_mixer_backend_list_streams (backend);
-    while (list != NULL) {
-        CafeMixerStream *stream = CAFE_MIXER_STREAM (list->data);
-
-        if (strcmp (name, cafe_mixer_stream_get_name (stream)) == 0)
-            return stream;
-
-        list = list->next;
-    }
-    return NULL;
+    return g_hash_table_lookup (backend->priv->streams, name);
 }
 
 CafeMixerStoredControl *
 cafe_mixer_backend_get_stored_control (CafeMixerBackend *backend, const gchar *name)
 {
-    const GList *list;
-
     g_return_val_if_fail (CAFE_MIXER_IS_BACKEND (backend), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = cafe_mixer_backend_list_stored_controls (backend);
-    while (list != NULL) {
-        CafeMixerStreamControl *control = CAFE_MIXER_STREAM_CONTROL (list->data);
+    return g_hash_table_lookup (backend->priv->stored_controls, name);
+}
 
-        if (strcmp (name, cafe_mixer_stream_control_get_name (control)) == 0)
-            return CAFE_MIXER_STORED_CONTROL (control);
+guint
+cafe_mixer_backend_get_generation (CafeMixerBackend *backend)
+{
+    g_return_val_if_fail (CAFE_MIXER_IS_BACKEND (backend), 0);
 
-        list = list->next;
-    }
-    return NULL;
+    return backend->priv->generation;
 }
 
 const GList *
@@ -523,39 +567,81 @@ cafe_mixer_backend_set_default_output_stream (CafeMixerBackend *backend,
     return TRUE;
 }
 
+void
+cafe_mixer_backend_begin_changes (CafeMixerBackend *backend)
+{
+    CafeMixerBackendClass *klass;
+
+    g_return_if_fail (CAFE_MIXER_IS_BACKEND (backend));
+
+    /* Only the outermost pair of calls has any effect */
+    if (backend->priv->changes_depth++ > 0)
+        return;
+
+    changing_backends = g_slist_prepend (changing_backends, backend);
+
+    klass = CAFE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->begin_changes != NULL)
+        klass->begin_changes (backend);
+}
+
+void
+cafe_mixer_backend_commit_changes (CafeMixerBackend *backend)
+{
+    CafeMixerBackendClass *klass;
+
+    g_return_if_fail (CAFE_MIXER_IS_BACKEND (backend));
+
+    /* The counter is reset when the backend is closed, so an unbalanced
+     * commit is not necessarily an error */
+    if (backend->priv->changes_depth == 0)
+        return;
+
+    if (--backend->priv->changes_depth > 0)
+        return;
+
+    klass = CAFE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->commit_changes != NULL)
+        klass->commit_changes (backend);
+
+    end_changes (backend);
+}
+
 static void
 device_added (CafeMixerBackend *backend, const gchar *name)
 {
     CafeMixerDevice *device;
 
-    device = cafe_mixer_backend_get_device (backend, name);
+    next_generation (backend);
+
+    /* The backend indexes the device before announcing it */
+    device = g_hash_table_lookup (backend->priv->devices, name);
     if (G_UNLIKELY (device == NULL)) {
         g_warn_if_reached ();
         return;
     }
 
-    /* Keep the device in a hash table as it won't be possible to retrieve
-     * it when the remove signal is received */
-    g_hash_table_insert (backend->priv->devices,
-                         g_strdup (name),
-                         g_object_ref (device));
-
     /* Connect to the stream signals from devices so we can forward them on
      * the backend */
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-added",
-                              G_CALLBACK (device_stream_added),
-                              backend);
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-removed",
-                              G_CALLBACK (device_stream_removed),
-                              backend);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-added",
+                      G_CALLBACK (device_stream_added),
+                      backend);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-removed",
+                      G_CALLBACK (device_stream_removed),
+                      backend);
 }
 
 static void
 device_removed (CafeMixerBackend *backend, const gchar *name)
 {
     CafeMixerDevice *device;
+    const GList     *list;
+
+    next_generation (backend);
 
     device = g_hash_table_lookup (backend->priv->devices, name);
     if (G_UNLIKELY (device == NULL)) {
@@ -570,12 +656,39 @@ device_removed (CafeMixerBackend *backend, const gchar *name)
                                           G_CALLBACK (device_stream_removed),
                                           backend);
 
+    /* Streams of the device which were not removed before the device itself
+     * would not be reported anymore, make sure they do not stay in the index */
+    list = cafe_mixer_device_list_streams (device);
+    while (list != NULL) {
+        CafeMixerStream *stream = CAFE_MIXER_STREAM (list->data);
+        const gchar     *stream_name;
+
+        stream_name = cafe_mixer_stream_get_name (stream);
+
+        if (g_hash_table_lookup (backend->priv->streams, stream_name) == stream)
+            g_hash_table_remove (backend->priv->streams, stream_name);
+
+        list = list->next;
+    }
+
     g_hash_table_remove (backend->priv->devices, name);
 }
 
 static void
-device_stream_added (CafeMixerBackend *backend, const gchar *name)
+device_stream_added (CafeMixerDevice  *device,
+                     const gchar      *name,
+                     CafeMixerBackend *backend)
 {
+    CafeMixerStream *stream;
+
+    /* The stream is looked up in the device, which is much cheaper than
+     * walking the list of all the streams of the backend */
+    stream = cafe_mixer_device_get_stream (device, name);
+    if (G_LIKELY (stream != NULL))
+        g_hash_table_insert (backend->priv->streams,
+                             g_strdup (name),
+                             g_object_ref (stream));
+
     g_signal_emit (G_OBJECT (backend),
                    signals[STREAM_ADDED],
                    0,
@@ -583,7 +696,9 @@ device_stream_added (CafeMixerBackend *backend, const gchar *name)
 }
 
 static void
-device_stream_removed (CafeMixerBackend *backend, const gchar *name)
+device_stream_removed (CafeMixerDevice  *device G_GNUC_UNUSED,
+                       const gchar      *name,
+                       CafeMixerBackend *backend)
 {
     g_signal_emit (G_OBJECT (backend),
                    signals[STREAM_REMOVED],
@@ -591,6 +706,92 @@ device_stream_removed (CafeMixerBackend *backend, const gchar *name)
                    name);
 }
 
+static void
+stream_added (CafeMixerBackend *backend, const gchar *name)
+{
+    next_generation (backend);
+
+    /* Streams are indexed by the backend before being announced, or when
+     * forwarded from devices */
+    if (G_UNLIKELY (g_hash_table_contains (backend->priv->streams, name) == FALSE))
+        g_warn_if_reached ();
+}
+
+static void
+stream_removed (CafeMixerBackend *backend, const gchar *name)
+{
+    next_generation (backend);
+
+    g_hash_table_remove (backend->priv->streams, name);
+}
+
+static void
+stored_control_added (CafeMixerBackend *backend, const gchar *name)
+{
+    next_generation (backend);
+
+    /* The backend indexes the control before announcing it */
+    if (G_UNLIKELY (g_hash_table_contains (backend->priv->stored_controls, name) == FALSE))
+        g_warn_if_reached ();
+}
+
+static void
+stored_control_removed (CafeMixerBackend *backend, const gchar *name)
+{
+    next_generation (backend);
+
+    g_hash_table_remove (backend->priv->stored_controls, name);
+}
+
+static void
+clear_indexes (CafeMixerBackend *backend)
+{
+    GHashTableIter iter;
+    gpointer       device;
+
+    g_hash_table_iter_init (&iter, backend->priv->devices);
+
+    while (g_hash_table_iter_next (&iter, NULL, &device) == TRUE) {
+        g_signal_handlers_disconnect_by_func (G_OBJECT (device),
+                                              G_CALLBACK (device_stream_added),
+                                              backend);
+        g_signal_handlers_disconnect_by_func (G_OBJECT (device),
+                                              G_CALLBACK (device_stream_removed),
+                                              backend);
+    }
+
+    g_hash_table_remove_all (backend->priv->devices);
+    g_hash_table_remove_all (backend->priv->streams);
+    g_hash_table_remove_all (backend->priv->stored_controls);
+
+    next_generation (backend);
+}
+
+static void
+next_generation (CafeMixerBackend *backend)
+{
+    /* Skip 0 when the counter wraps around */
+    if (G_UNLIKELY (++backend->priv->generation == 0))
+        backend->priv->generation = 1;
+}
+
+static void
+thaw_control (gpointer control)
+{
+    g_object_thaw_notify (G_OBJECT (control));
+    g_object_unref (control);
+}
+
+static void
+end_changes (CafeMixerBackend *backend)
+{
+    backend->priv->changes_depth = 0;
+
+    changing_backends = g_slist_remove (changing_backends, backend);
+
+    g_hash_table_remove_all (backend->priv->frozen_controls);
+}
+
 /* Protected functions */
 void
 _cafe_mixer_backend_set_state (CafeMixerBackend *backend, CafeMixerState state)
@@ -602,6 +803,15 @@ _cafe_mixer_backend_set_state (CafeMixerBackend *backend, CafeMixerState state)
 
     backend->priv->state = state;
 
+    /* Backends drop their objects without emitting removal signals when
+     * they are closed */
+    if (state == CAFE_MIXER_STATE_IDLE) {
+        clear_indexes (backend);
+
+        /* Pending changes are lost together with the connection */
+        end_changes (backend);
+    }
+
     g_object_notify_by_pspec (G_OBJECT (backend), properties[PROP_STATE]);
 }
 
@@ -654,3 +864,67 @@ _cafe_mixer_backend_set_default_output_stream (CafeMixerBackend *backend,
     g_object_notify_by_pspec (G_OBJECT (backend),
                               properties[PROP_DEFAULT_OUTPUT_STREAM]);
 }
+
+void
+_cafe_mixer_backend_index_device (CafeMixerBackend *backend, CafeMixerDevice *device)
+{
+    g_return_if_fail (CAFE_MIXER_IS_BACKEND (backend));
+    g_return_if_fail (CAFE_MIXER_IS_DEVICE (device));
+
+    /* Keep the device in a hash table as it won't be possible to retrieve
+     * it when the remove signal is received */
+    g_hash_table_insert (backend->priv->devices,
+                         g_strdup (cafe_mixer_device_get_name (device)),
+                         g_object_ref (device));
+}
+
+void
+_cafe_mixer_backend_index_stream (CafeMixerBackend *backend, CafeMixerStream *stream)
+{
+    g_return_if_fail (CAFE_MIXER_IS_BACKEND (backend));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+
+    g_hash_table_insert (backend->priv->streams,
+                         g_strdup (cafe_mixer_stream_get_name (stream)),
+                         g_object_ref (stream));
+}
+
+void
+_cafe_mixer_backend_index_stored_control (CafeMixerBackend       *backend,
+                                          CafeMixerStoredControl *control)
+{
+    const gchar *name;
+
+    g_return_if_fail (CAFE_MIXER_IS_BACKEND (backend));
+    g_return_if_fail (CAFE_MIXER_IS_STORED_CONTROL (control));
+
+    name = cafe_mixer_stream_control_get_name (CAFE_MIXER_STREAM_CONTROL (control));
+
+    g_hash_table_insert (backend->priv->stored_controls,
+                         g_strdup (name),
+                         g_object_ref (control));
+}
+
+void
+_cafe_mixer_backend_freeze_control (CafeMixerStreamControl *control)
+{
+    CafeMixerBackend *backend;
+
+    g_return_if_fail (CAFE_MIXER_IS_STREAM_CONTROL (control));
+
+    if (changing_backends == NULL)
+        return;
+
+    /* Controls do not reference their backend, the change is assumed to
+     * belong to the most recently started batch of changes */
+    backend = CAFE_MIXER_BACKEND (changing_backends->data);
+
+    if (g_hash_table_contains (backend->priv->frozen_controls, control) == TRUE)
+        return;
+
+    /* Notifications of the control are delayed until the changes are
+     * committed, so it notifies at most once per changed property */
+    g_object_freeze_notify (G_OBJECT (control));
+
+    g_hash_table_add (backend->priv->frozen_controls, g_object_ref (control));
+}
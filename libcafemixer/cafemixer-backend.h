@@ -73,6 +73,9 @@ struct _CafeMixerBackendClass
     gboolean     (*set_default_output_stream) (CafeMixerBackend *backend,
                                                CafeMixerStream  *stream);
 
+    void         (*begin_changes)             (CafeMixerBackend *backend);
+    void         (*commit_changes)            (CafeMixerBackend *backend);
+
     /* Signals */
     void         (*device_added)              (CafeMixerBackend *backend,
                                                const gchar      *name);
@@ -107,6 +110,8 @@ CafeMixerStream *       cafe_mixer_backend_get_stream                (CafeMixerB
 CafeMixerStoredControl *cafe_mixer_backend_get_stored_control        (CafeMixerBackend *backend,
                                                                       const gchar      *name);
 
+guint                   cafe_mixer_backend_get_generation            (CafeMixerBackend *backend);
+
 const GList *           cafe_mixer_backend_list_devices              (CafeMixerBackend *backend);
 const GList *           cafe_mixer_backend_list_streams              (CafeMixerBackend *backend);
 const GList *           cafe_mixer_backend_list_stored_controls      (CafeMixerBackend *backend);
@@ -119,6 +124,9 @@ CafeMixerStream *       cafe_mixer_backend_get_default_output_stream (CafeMixerB
 gboolean                cafe_mixer_backend_set_default_output_stream (CafeMixerBackend *backend,
                                                                       CafeMixerStream  *stream);
 
+void                    cafe_mixer_backend_begin_changes             (CafeMixerBackend *backend);
+void                    cafe_mixer_backend_commit_changes            (CafeMixerBackend *backend);
+
 /* Protected functions */
 void                   _cafe_mixer_backend_set_state                 (CafeMixerBackend *backend,
                                                                       CafeMixerState    state);
@@ -129,6 +137,14 @@ void                   _cafe_mixer_backend_set_default_input_stream  (CafeMixerB
 void                   _cafe_mixer_backend_set_default_output_stream (CafeMixerBackend *backend,
                                                                       CafeMixerStream  *stream);
 
+/* Objects are indexed right before the respective added signal is emitted */
+void                   _cafe_mixer_backend_index_device              (CafeMixerBackend       *backend,
+                                                                      CafeMixerDevice        *device);
+void                   _cafe_mixer_backend_index_stream              (CafeMixerBackend       *backend,
+                                                                      CafeMixerStream        *stream);
+void                   _cafe_mixer_backend_index_stored_control      (CafeMixerBackend       *backend,
+                                                                      CafeMixerStoredControl *control);
+
 G_END_DECLS
 
 #endif /* CAFEMIXER_BACKEND_H */
@@ -17,6 +17,7 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <gio/gio.h>
 
 #include "cafemixer.h"
 #include "cafemixer-backend.h"
@@ -42,7 +43,8 @@
  * not necessary, by default the context will select a working sound system
  * backend automatically.
  *
- * To connect to a sound system, use cafe_mixer_context_open().
+ * To connect to a sound system, use cafe_mixer_context_open() or
+ * cafe_mixer_context_open_async().
  *
  * When the connection is established, it is possible to query a list of sound
  * devices with cafe_mixer_context_list_devices() and streams with
@@ -79,8 +81,33 @@ struct _CafeMixerContextPrivate
     CafeMixerAppInfo       *app_info;
     CafeMixerBackendType    backend_type;
     CafeMixerBackendModule *module;
+    GTask                  *open_task;
 };
 
+/* Time in milliseconds an asynchronous open waits for a higher priority backend
+ * before settling for a lower priority one which is already usable */
+#define OPEN_PROBE_TIMEOUT 2000
+
+/* Time in milliseconds an asynchronous open waits for the most recently started
+ * backend before starting the next one */
+#define OPEN_PROBE_DELAY   250
+
+typedef struct
+{
+    CafeMixerBackendModule *module;
+    CafeMixerBackend       *backend;
+} OpenProbe;
+
+typedef struct
+{
+    GList    *modules;
+    GList    *probes;
+    GSource  *delay_source;
+    GSource  *timeout_source;
+    GSource  *cancel_source;
+    gboolean  deadline_passed;
+} OpenData;
+
 enum {
     PROP_0,
     PROP_APP_NAME,
@@ -156,6 +183,29 @@ static void     on_backend_default_output_stream_notify (CafeMixerBackend *backe
 
 static gboolean try_next_backend                        (CafeMixerContext *context);
 
+static OpenProbe *open_probe_new                        (CafeMixerContext       *context,
+                                                         CafeMixerBackendModule *module);
+static void     open_probe_free                         (OpenProbe              *probe);
+
+static void     start_next_probe                        (CafeMixerContext       *context);
+
+static void     open_data_clear                         (OpenData               *data);
+static void     open_data_free                          (OpenData               *data);
+
+static void     on_probe_state_notify                   (CafeMixerBackend       *backend,
+                                                         GParamSpec             *pspec,
+                                                         CafeMixerContext       *context);
+static gboolean on_open_delay                           (CafeMixerContext       *context);
+static gboolean on_open_timeout                         (CafeMixerContext       *context);
+static gboolean on_open_cancelled                       (GCancellable           *cancellable,
+                                                         CafeMixerContext       *context);
+
+static void     select_probe                            (CafeMixerContext       *context);
+static void     choose_probe                            (CafeMixerContext       *context,
+                                                         OpenProbe              *probe);
+static void     abort_open                              (CafeMixerContext       *context,
+                                                         GError                 *error);
+
 static void     change_state                            (CafeMixerContext *context,
                                                          CafeMixerState    state);
 
@@ -836,6 +886,19 @@ cafe_mixer_context_open (CafeMixerContext *context)
         module = CAFE_MIXER_BACKEND_MODULE (modules->data);
     }
 
+    /* The module is loaded when it is used for the first time */
+    if (cafe_mixer_backend_module_load (module) == FALSE) {
+        if (context->priv->backend_type == CAFE_MIXER_BACKEND_UNKNOWN) {
+            context->priv->module = g_object_ref (module);
+
+            change_state (context, CAFE_MIXER_STATE_CONNECTING);
+            return try_next_backend (context);
+        }
+
+        change_state (context, CAFE_MIXER_STATE_FAILED);
+        return FALSE;
+    }
+
     if (info == NULL)
         info = cafe_mixer_backend_module_get_info (module);
 
@@ -889,6 +952,139 @@ cafe_mixer_context_open (CafeMixerContext *context)
     return TRUE;
 }
 
+/**
+ * cafe_mixer_context_open_async:
+ * @context: a #CafeMixerContext
+ * @cancellable: (allow-none): a #GCancellable or %NULL
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request
+ * is satisfied
+ * @user_data: (closure): the data to pass to the callback function
+ *
+ * Asynchronously opens connection to a sound system.
+ *
+ * Unlike cafe_mixer_context_open(), which waits for each of the available
+ * backends to fail before trying the next one, this function starts the
+ * highest priority backend first and starts the next one when the previous
+ * one fails or has not become ready within a short delay, so several backends
+ * may be connecting at the same time. Backends which are not needed are not
+ * loaded at all. The highest priority backend which becomes ready is chosen
+ * as soon as all the backends with a higher priority have failed. If a higher priority
+ * backend is still connecting after a short deadline, the highest priority
+ * backend that is already ready is used instead, so a slow or unresponsive
+ * sound server does not delay the application.
+ *
+ * If the sound system backend type was chosen with
+ * cafe_mixer_context_set_backend_type(), only that backend is tried.
+ *
+ * The #CafeMixerContext:state changes to %CAFE_MIXER_STATE_CONNECTING right
+ * away. When the operation is finished, @callback will be called from the
+ * thread-default main context of the thread calling this function. You can
+ * then call cafe_mixer_context_open_finish() to get the result of the operation.
+ */
+void
+cafe_mixer_context_open_async (CafeMixerContext   *context,
+                               GCancellable       *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer            user_data)
+{
+    GTask       *task;
+    OpenData    *data;
+    const GList *modules;
+
+    g_return_if_fail (CAFE_MIXER_IS_CONTEXT (context));
+    g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+    task = g_task_new (context, cancellable, callback, user_data);
+    g_task_set_source_tag (task, cafe_mixer_context_open_async);
+
+    if (context->priv->state == CAFE_MIXER_STATE_CONNECTING ||
+        context->priv->state == CAFE_MIXER_STATE_READY) {
+        g_task_return_new_error (task,
+                                 G_IO_ERROR,
+                                 G_IO_ERROR_BUSY,
+                                 "The context is already open or being opened");
+        g_object_unref (task);
+        return;
+    }
+
+    if (g_task_return_error_if_cancelled (task) == TRUE) {
+        g_object_unref (task);
+        return;
+    }
+
+    data = g_slice_new0 (OpenData);
+    g_task_set_task_data (task, data, (GDestroyNotify) open_data_free);
+
+    context->priv->open_task = task;
+
+    change_state (context, CAFE_MIXER_STATE_CONNECTING);
+
+    /* Collect the candidate backends, the list of modules is sorted by priority
+     * and so will be the list of probes */
+    modules = _cafe_mixer_list_modules ();
+
+    while (modules != NULL) {
+        CafeMixerBackendModule     *module;
+        const CafeMixerBackendInfo *info;
+
+        module = CAFE_MIXER_BACKEND_MODULE (modules->data);
+        info   = cafe_mixer_backend_module_get_info (module);
+
+        modules = modules->next;
+
+        if (context->priv->backend_type != CAFE_MIXER_BACKEND_UNKNOWN &&
+            context->priv->backend_type != info->backend_type)
+            continue;
+
+        data->modules = g_list_prepend (data->modules, g_object_ref (module));
+    }
+    data->modules = g_list_reverse (data->modules);
+
+    data->timeout_source = g_timeout_source_new (OPEN_PROBE_TIMEOUT);
+    g_source_set_callback (data->timeout_source,
+                           (GSourceFunc) on_open_timeout,
+                           context,
+                           NULL);
+    g_source_attach (data->timeout_source, g_task_get_context (task));
+
+    if (cancellable != NULL) {
+        data->cancel_source = g_cancellable_source_new (cancellable);
+        g_source_set_callback (data->cancel_source,
+                               (GSourceFunc) on_open_cancelled,
+                               context,
+                               NULL);
+        g_source_attach (data->cancel_source, g_task_get_context (task));
+    }
+
+    start_next_probe (context);
+
+    /* Some backends become ready instantly, in which case the operation may
+     * already be complete */
+    select_probe (context);
+}
+
+/**
+ * cafe_mixer_context_open_finish:
+ * @context: a #CafeMixerContext
+ * @result: a #GAsyncResult
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes an operation started with cafe_mixer_context_open_async().
+ *
+ * Returns: %TRUE if the connection has been established, or %FALSE with
+ * @error set on failure.
+ */
+gboolean
+cafe_mixer_context_open_finish (CafeMixerContext *context,
+                                GAsyncResult     *result,
+                                GError          **error)
+{
+    g_return_val_if_fail (CAFE_MIXER_IS_CONTEXT (context), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, context), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /**
  * cafe_mixer_context_close:
  * @context: a #CafeMixerContext
@@ -984,6 +1180,36 @@ cafe_mixer_context_get_stored_control (CafeMixerContext *context, const gchar *n
     return cafe_mixer_backend_get_stored_control (CAFE_MIXER_BACKEND (context->priv->backend), name);
 }
 
+/**
+ * cafe_mixer_context_get_generation:
+ * @context: a #CafeMixerContext
+ *
+ * Gets a counter which changes whenever a device, stream or stored control is
+ * added or removed.
+ *
+ * The lists returned by cafe_mixer_context_list_devices(),
+ * cafe_mixer_context_list_streams() and cafe_mixer_context_list_stored_controls()
+ * are guaranteed not to have changed as long as the counter stays the same,
+ * which allows callers to cheaply find out whether a list they have processed
+ * before needs to be processed again.
+ *
+ * A valid generation is never 0, so 0 can be used by callers as the initial
+ * value of the last seen generation.
+ *
+ * Returns: the current generation of the lists or 0 if you are not connected
+ * to a sound system.
+ */
+guint
+cafe_mixer_context_get_generation (CafeMixerContext *context)
+{
+    g_return_val_if_fail (CAFE_MIXER_IS_CONTEXT (context), 0);
+
+    if (context->priv->state != CAFE_MIXER_STATE_READY)
+        return 0;
+
+    return cafe_mixer_backend_get_generation (CAFE_MIXER_BACKEND (context->priv->backend));
+}
+
 /**
  * cafe_mixer_context_list_devices:
  * @context: a #CafeMixerContext
@@ -1147,6 +1373,53 @@ cafe_mixer_context_set_default_output_stream (CafeMixerContext *context,
     return cafe_mixer_backend_set_default_output_stream (context->priv->backend, stream);
 }
 
+/**
+ * cafe_mixer_context_begin_changes:
+ * @context: a #CafeMixerContext
+ *
+ * Starts collecting changes made to controls. Until the matching call to
+ * cafe_mixer_context_commit_changes(), changes may be held back by the sound
+ * system backend and sent as a single batch, and notifications of property
+ * changes of controls are delayed.
+ *
+ * This is useful when changing many controls at once, for example when
+ * restoring a saved state of the mixer.
+ *
+ * Calls to this function may be nested, the changes are committed when the
+ * outermost call is matched by cafe_mixer_context_commit_changes().
+ */
+void
+cafe_mixer_context_begin_changes (CafeMixerContext *context)
+{
+    g_return_if_fail (CAFE_MIXER_IS_CONTEXT (context));
+
+    if (context->priv->backend == NULL)
+        return;
+
+    cafe_mixer_backend_begin_changes (context->priv->backend);
+}
+
+/**
+ * cafe_mixer_context_commit_changes:
+ * @context: a #CafeMixerContext
+ *
+ * Applies the changes collected since the call to
+ * cafe_mixer_context_begin_changes() and emits the delayed notifications.
+ *
+ * If the connection to the sound system is lost before this function is
+ * called, the collected changes are discarded.
+ */
+void
+cafe_mixer_context_commit_changes (CafeMixerContext *context)
+{
+    g_return_if_fail (CAFE_MIXER_IS_CONTEXT (context));
+
+    if (context->priv->backend == NULL)
+        return;
+
+    cafe_mixer_backend_commit_changes (context->priv->backend);
+}
+
 /**
  * cafe_mixer_context_get_backend_name:
  * @context: a #CafeMixerContext
@@ -1361,6 +1634,13 @@ try_next_backend (CafeMixerContext *context)
         return FALSE;
     }
 
+    if (cafe_mixer_backend_module_load (module) == FALSE) {
+        /* Keep the module to let the next call find its position in the list */
+        context->priv->module = g_object_ref (module);
+
+        return try_next_backend (context);
+    }
+
     info = cafe_mixer_backend_module_get_info (module);
 
     context->priv->module  = g_object_ref (module);
@@ -1395,6 +1675,318 @@ try_next_backend (CafeMixerContext *context)
     return TRUE;
 }
 
+static OpenProbe *
+open_probe_new (CafeMixerContext *context, CafeMixerBackendModule *module)
+{
+    OpenProbe                  *probe;
+    CafeMixerBackend           *backend;
+    CafeMixerState              state;
+    const CafeMixerBackendInfo *info;
+
+    if (cafe_mixer_backend_module_load (module) == FALSE)
+        return NULL;
+
+    info = cafe_mixer_backend_module_get_info (module);
+
+    backend = g_object_new (info->g_type, NULL);
+
+    cafe_mixer_backend_set_app_info (backend, context->priv->app_info);
+    cafe_mixer_backend_set_server_address (backend, context->priv->server_address);
+
+    g_debug ("Probing backend %s", info->name);
+
+    if (cafe_mixer_backend_open (backend) == FALSE) {
+        g_debug ("Backend %s failed to open", info->name);
+
+        g_object_unref (backend);
+        return NULL;
+    }
+
+    state = cafe_mixer_backend_get_state (backend);
+
+    if (G_UNLIKELY (state != CAFE_MIXER_STATE_READY &&
+                    state != CAFE_MIXER_STATE_CONNECTING)) {
+        /* This would be a backend bug */
+        g_warn_if_reached ();
+
+        cafe_mixer_backend_close (backend);
+        g_object_unref (backend);
+        return NULL;
+    }
+
+    g_signal_connect (G_OBJECT (backend),
+                      "notify::state",
+                      G_CALLBACK (on_probe_state_notify),
+                      context);
+
+    probe = g_slice_new (OpenProbe);
+    probe->module  = g_object_ref (module);
+    probe->backend = backend;
+
+    return probe;
+}
+
+static void
+open_probe_free (OpenProbe *probe)
+{
+    if (probe->backend != NULL) {
+        g_signal_handlers_disconnect_matched (G_OBJECT (probe->backend),
+                                              G_SIGNAL_MATCH_FUNC,
+                                              0, 0, NULL,
+                                              on_probe_state_notify,
+                                              NULL);
+
+        cafe_mixer_backend_close (probe->backend);
+        g_object_unref (probe->backend);
+    }
+
+    if (probe->module != NULL)
+        g_object_unref (probe->module);
+
+    g_slice_free (OpenProbe, probe);
+}
+
+static void
+start_next_probe (CafeMixerContext *context)
+{
+    OpenData *data;
+
+    data = g_task_get_task_data (context->priv->open_task);
+
+    if (data->delay_source != NULL) {
+        g_source_destroy (data->delay_source);
+        g_clear_pointer (&data->delay_source, g_source_unref);
+    }
+
+    /* Start the highest priority backend which has not been tried yet, modules
+     * which cannot be loaded or opened are skipped right away */
+    while (data->modules != NULL) {
+        CafeMixerBackendModule *module;
+        OpenProbe              *probe;
+
+        module = CAFE_MIXER_BACKEND_MODULE (data->modules->data);
+
+        data->modules = g_list_delete_link (data->modules, data->modules);
+
+        probe = open_probe_new (context, module);
+        g_object_unref (module);
+
+        if (probe != NULL) {
+            data->probes = g_list_append (data->probes, probe);
+            break;
+        }
+    }
+
+    if (data->modules == NULL)
+        return;
+
+    /* Give the backend a moment to become ready before starting the next one */
+    data->delay_source = g_timeout_source_new (OPEN_PROBE_DELAY);
+    g_source_set_callback (data->delay_source,
+                           (GSourceFunc) on_open_delay,
+                           context,
+                           NULL);
+    g_source_attach (data->delay_source, g_task_get_context (context->priv->open_task));
+}
+
+static void
+open_data_clear (OpenData *data)
+{
+    if (data->delay_source != NULL) {
+        g_source_destroy (data->delay_source);
+        g_clear_pointer (&data->delay_source, g_source_unref);
+    }
+    if (data->timeout_source != NULL) {
+        g_source_destroy (data->timeout_source);
+        g_clear_pointer (&data->timeout_source, g_source_unref);
+    }
+    if (data->cancel_source != NULL) {
+        g_source_destroy (data->cancel_source);
+        g_clear_pointer (&data->cancel_source, g_source_unref);
+    }
+
+    g_list_free_full (data->modules, g_object_unref);
+    data->modules = NULL;
+
+    g_list_free_full (data->probes, (GDestroyNotify) open_probe_free);
+    data->probes = NULL;
+}
+
+static void
+open_data_free (OpenData *data)
+{
+    open_data_clear (data);
+
+    g_slice_free (OpenData, data);
+}
+
+static void
+on_probe_state_notify (CafeMixerBackend *backend,
+                       GParamSpec       *pspec G_GNUC_UNUSED,
+                       CafeMixerContext *context)
+{
+    OpenData *data;
+    GList    *list;
+
+    data = g_task_get_task_data (context->priv->open_task);
+
+    if (cafe_mixer_backend_get_state (backend) != CAFE_MIXER_STATE_FAILED) {
+        select_probe (context);
+        return;
+    }
+
+    for (list = data->probes; list != NULL; list = list->next) {
+        OpenProbe *probe = list->data;
+
+        if (probe->backend == backend) {
+            g_debug ("Backend %s changed state to FAILED",
+                     cafe_mixer_backend_module_get_info (probe->module)->name);
+
+            data->probes = g_list_delete_link (data->probes, list);
+            open_probe_free (probe);
+            break;
+        }
+    }
+
+    /* Do not wait for the delay to elapse when a backend fails */
+    start_next_probe (context);
+    select_probe (context);
+}
+
+static gboolean
+on_open_delay (CafeMixerContext *context)
+{
+    OpenData *data;
+
+    data = g_task_get_task_data (context->priv->open_task);
+
+    g_clear_pointer (&data->delay_source, g_source_unref);
+
+    start_next_probe (context);
+    select_probe (context);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+on_open_timeout (CafeMixerContext *context)
+{
+    OpenData *data;
+
+    data = g_task_get_task_data (context->priv->open_task);
+
+    g_clear_pointer (&data->timeout_source, g_source_unref);
+
+    /* From now on any backend which is ready can be used */
+    data->deadline_passed = TRUE;
+
+    select_probe (context);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+on_open_cancelled (GCancellable     *cancellable G_GNUC_UNUSED,
+                   CafeMixerContext *context)
+{
+    change_state (context, CAFE_MIXER_STATE_IDLE);
+
+    abort_open (context,
+                g_error_new_literal (G_IO_ERROR,
+                                     G_IO_ERROR_CANCELLED,
+                                     "Operation was cancelled"));
+
+    /* The source has been destroyed by abort_open() */
+    return G_SOURCE_REMOVE;
+}
+
+static void
+select_probe (CafeMixerContext *context)
+{
+    OpenData *data;
+    GList    *list;
+
+    data = g_task_get_task_data (context->priv->open_task);
+
+    /* Failed backends are removed from the list, so each of the remaining ones
+     * is either ready or still connecting */
+    for (list = data->probes; list != NULL; list = list->next) {
+        OpenProbe *probe = list->data;
+
+        if (cafe_mixer_backend_get_state (probe->backend) == CAFE_MIXER_STATE_READY) {
+            choose_probe (context, probe);
+            return;
+        }
+
+        /* Before the deadline a backend is only chosen after all the backends
+         * with a higher priority have failed */
+        if (data->deadline_passed == FALSE)
+            return;
+    }
+
+    if (data->probes == NULL && data->modules == NULL) {
+        /* All the backends have failed */
+        change_state (context, CAFE_MIXER_STATE_FAILED);
+
+        abort_open (context,
+                    g_error_new_literal (G_IO_ERROR,
+                                         G_IO_ERROR_FAILED,
+                                         "No sound system backend could be opened"));
+    }
+}
+
+static void
+choose_probe (CafeMixerContext *context, OpenProbe *probe)
+{
+    GTask    *task;
+    OpenData *data;
+
+    task = context->priv->open_task;
+    data = g_task_get_task_data (task);
+
+    context->priv->open_task = NULL;
+
+    g_debug ("Backend %s chosen",
+             cafe_mixer_backend_module_get_info (probe->module)->name);
+
+    /* Take over the backend and close the other ones */
+    data->probes = g_list_remove (data->probes, probe);
+
+    g_signal_handlers_disconnect_by_func (G_OBJECT (probe->backend),
+                                          on_probe_state_notify,
+                                          context);
+
+    context->priv->module  = probe->module;
+    context->priv->backend = probe->backend;
+
+    g_slice_free (OpenProbe, probe);
+
+    open_data_clear (data);
+
+    g_signal_connect (G_OBJECT (context->priv->backend),
+                      "notify::state",
+                      G_CALLBACK (on_backend_state_notify),
+                      context);
+
+    change_state (context, CAFE_MIXER_STATE_READY);
+
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+static void
+abort_open (CafeMixerContext *context, GError *error)
+{
+    GTask *task;
+
+    task = context->priv->open_task;
+
+    context->priv->open_task = NULL;
+
+    open_data_clear (g_task_get_task_data (task));
+
+    g_task_return_error (task, error);
+    g_object_unref (task);
+}
+
 static void
 change_state (CafeMixerContext *context, CafeMixerState state)
 {
@@ -1451,6 +2043,12 @@ change_state (CafeMixerContext *context, CafeMixerState state)
 static void
 close_context (CafeMixerContext *context)
 {
+    if (context->priv->open_task != NULL)
+        abort_open (context,
+                    g_error_new_literal (G_IO_ERROR,
+                                         G_IO_ERROR_CANCELLED,
+                                         "The context has been closed"));
+
     if (context->priv->backend != NULL) {
         g_signal_handlers_disconnect_by_data (G_OBJECT (context->priv->backend),
                                               context);
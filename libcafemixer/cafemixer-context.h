@@ -20,6 +20,7 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <gio/gio.h>
 
 #include <libcafemixer/cafemixer-enums.h>
 #include <libcafemixer/cafemixer-types.h>
@@ -99,6 +100,13 @@ gboolean                cafe_mixer_context_set_server_address        (CafeMixerC
                                                                       const gchar          *address);
 
 gboolean                cafe_mixer_context_open                      (CafeMixerContext     *context);
+void                    cafe_mixer_context_open_async                (CafeMixerContext     *context,
+                                                                      GCancellable         *cancellable,
+                                                                      GAsyncReadyCallback   callback,
+                                                                      gpointer              user_data);
+gboolean                cafe_mixer_context_open_finish               (CafeMixerContext     *context,
+                                                                      GAsyncResult         *result,
+                                                                      GError              **error);
 void                    cafe_mixer_context_close                     (CafeMixerContext     *context);
 
 CafeMixerState          cafe_mixer_context_get_state                 (CafeMixerContext     *context);
@@ -110,6 +118,8 @@ CafeMixerStream *       cafe_mixer_context_get_stream                (CafeMixerC
 CafeMixerStoredControl *cafe_mixer_context_get_stored_control        (CafeMixerContext     *context,
                                                                       const gchar          *name);
 
+guint                   cafe_mixer_context_get_generation            (CafeMixerContext     *context);
+
 const GList *           cafe_mixer_context_list_devices              (CafeMixerContext     *context);
 const GList *           cafe_mixer_context_list_streams              (CafeMixerContext     *context);
 const GList *           cafe_mixer_context_list_stored_controls      (CafeMixerContext     *context);
@@ -122,6 +132,9 @@ CafeMixerStream *       cafe_mixer_context_get_default_output_stream (CafeMixerC
 gboolean                cafe_mixer_context_set_default_output_stream (CafeMixerContext     *context,
                                                                       CafeMixerStream      *stream);
 
+void                    cafe_mixer_context_begin_changes             (CafeMixerContext     *context);
+void                    cafe_mixer_context_commit_changes            (CafeMixerContext     *context);
+
 const gchar *           cafe_mixer_context_get_backend_name          (CafeMixerContext     *context);
 CafeMixerBackendType    cafe_mixer_context_get_backend_type          (CafeMixerContext     *context);
 CafeMixerBackendFlags   cafe_mixer_context_get_backend_flags         (CafeMixerContext     *context);
@@ -20,7 +20,9 @@
 #include <glib-object.h>
 
 #include "cafemixer-device.h"
+#include "cafemixer-device-private.h"
 #include "cafemixer-device-switch.h"
+#include "cafemixer-name-index.h"
 #include "cafemixer-stream.h"
 #include "cafemixer-switch.h"
 
@@ -36,9 +38,11 @@
 
 struct _CafeMixerDevicePrivate
 {
-    gchar *name;
-    gchar *label;
-    gchar *icon;
+    gchar              *name;
+    gchar              *label;
+    gchar              *icon;
+    CafeMixerNameIndex *streams_index;
+    CafeMixerNameIndex *switches_index;
 };
 
 enum {
@@ -70,6 +74,7 @@ static void cafe_mixer_device_set_property (GObject              *object,
                                             const GValue         *value,
                                             GParamSpec           *pspec);
 
+static void cafe_mixer_device_dispose      (GObject              *object);
 static void cafe_mixer_device_finalize     (GObject              *object);
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (CafeMixerDevice, cafe_mixer_device, G_TYPE_OBJECT)
@@ -88,6 +93,7 @@ cafe_mixer_device_class_init (CafeMixerDeviceClass *klass)
     klass->get_switch = cafe_mixer_device_real_get_switch;
 
     object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose      = cafe_mixer_device_dispose;
     object_class->finalize     = cafe_mixer_device_finalize;
     object_class->get_property = cafe_mixer_device_get_property;
     object_class->set_property = cafe_mixer_device_set_property;
@@ -291,6 +297,23 @@ cafe_mixer_device_init (CafeMixerDevice *device)
     device->priv = cafe_mixer_device_get_instance_private (device);
 }
 
+static void
+cafe_mixer_device_dispose (GObject *object)
+{
+    CafeMixerDevice *device;
+
+    device = CAFE_MIXER_DEVICE (object);
+
+    /* Subclasses release their elements without removing them from the
+     * indexes when they are disposed */
+    if (device->priv->streams_index != NULL)
+        _cafe_mixer_name_index_clear (device->priv->streams_index);
+    if (device->priv->switches_index != NULL)
+        _cafe_mixer_name_index_clear (device->priv->switches_index);
+
+    G_OBJECT_CLASS (cafe_mixer_device_parent_class)->dispose (object);
+}
+
 static void
 cafe_mixer_device_finalize (GObject *object)
 {
@@ -302,6 +325,11 @@ cafe_mixer_device_finalize (GObject *object)
     g_free (device->priv->label);
     g_free (device->priv->icon);
 
+    if (device->priv->streams_index != NULL)
+        _cafe_mixer_name_index_free (device->priv->streams_index);
+    if (device->priv->switches_index != NULL)
+        _cafe_mixer_name_index_free (device->priv->switches_index);
+
     G_OBJECT_CLASS (cafe_mixer_device_parent_class)->finalize (object);
 }
 
@@ -475,6 +503,10 @@ cafe_mixer_device_real_get_stream (CafeMixerDevice *device, const gchar *name)
     g_return_val_if_fail (CAFE_MIXER_IS_DEVICE (device), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
+    /* The index is authoritative once the subclass started feeding it */
+    if (device->priv->streams_index != NULL)
+        return _cafe_mixer_name_index_lookup (device->priv->streams_index, name);
+
     list = cafe_mixer_device_list_streams (device);
     while (list != NULL) {
         CafeMixerStream *stream = CAFE_MIXER_STREAM (list->data);
@@ -495,6 +527,9 @@ cafe_mixer_device_real_get_switch (CafeMixerDevice *device, const gchar *name)
     g_return_val_if_fail (CAFE_MIXER_IS_DEVICE (device), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
+    if (device->priv->switches_index != NULL)
+        return _cafe_mixer_name_index_lookup (device->priv->switches_index, name);
+
     list = cafe_mixer_device_list_switches (device);
     while (list != NULL) {
         CafeMixerSwitch *swtch = CAFE_MIXER_SWITCH (list->data);
@@ -506,3 +541,44 @@ cafe_mixer_device_real_get_switch (CafeMixerDevice *device, const gchar *name)
     }
     return NULL;
 }
+
+/* Protected functions */
+void
+_cafe_mixer_device_index_stream (CafeMixerDevice *device, CafeMixerStream *stream)
+{
+    g_return_if_fail (CAFE_MIXER_IS_DEVICE (device));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+
+    if (device->priv->streams_index == NULL)
+        device->priv->streams_index = _cafe_mixer_name_index_new ();
+
+    _cafe_mixer_name_index_insert (device->priv->streams_index,
+                                   cafe_mixer_stream_get_name (stream),
+                                   stream);
+}
+
+void
+_cafe_mixer_device_unindex_stream (CafeMixerDevice *device, CafeMixerStream *stream)
+{
+    g_return_if_fail (CAFE_MIXER_IS_DEVICE (device));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+
+    if (device->priv->streams_index != NULL)
+        _cafe_mixer_name_index_remove (device->priv->streams_index,
+                                       cafe_mixer_stream_get_name (stream),
+                                       stream);
+}
+
+void
+_cafe_mixer_device_index_switch (CafeMixerDevice *device, CafeMixerDeviceSwitch *swtch)
+{
+    g_return_if_fail (CAFE_MIXER_IS_DEVICE (device));
+    g_return_if_fail (CAFE_MIXER_IS_DEVICE_SWITCH (swtch));
+
+    if (device->priv->switches_index == NULL)
+        device->priv->switches_index = _cafe_mixer_name_index_new ();
+
+    _cafe_mixer_name_index_insert (device->priv->switches_index,
+                                   cafe_mixer_switch_get_name (CAFE_MIXER_SWITCH (swtch)),
+                                   swtch);
+}
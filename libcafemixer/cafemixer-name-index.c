@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+#include "cafemixer-name-index.h"
+
+/*
+ * A name index maps element names to the elements themselves, it is used by
+ * the base classes to avoid walking lists when looking up an element by name.
+ *
+ * The index does not hold references to the indexed objects, the owner of
+ * the index is responsible for removing an object from the index when the
+ * object is removed from the list it belongs to.
+ */
+struct _CafeMixerNameIndex
+{
+    GHashTable *table;
+};
+
+CafeMixerNameIndex *
+_cafe_mixer_name_index_new (void)
+{
+    CafeMixerNameIndex *index;
+
+    index = g_slice_new (CafeMixerNameIndex);
+    index->table = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          g_free,
+                                          NULL);
+    return index;
+}
+
+void
+_cafe_mixer_name_index_free (CafeMixerNameIndex *index)
+{
+    g_return_if_fail (index != NULL);
+
+    g_hash_table_unref (index->table);
+    g_slice_free (CafeMixerNameIndex, index);
+}
+
+void
+_cafe_mixer_name_index_insert (CafeMixerNameIndex *index,
+                               const gchar        *name,
+                               gpointer            object)
+{
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (name != NULL);
+    g_return_if_fail (object != NULL);
+
+    g_hash_table_insert (index->table, g_strdup (name), object);
+}
+
+void
+_cafe_mixer_name_index_remove (CafeMixerNameIndex *index,
+                               const gchar        *name,
+                               gpointer            object)
+{
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (name != NULL);
+
+    /* Another object with the same name may have replaced this one */
+    if (g_hash_table_lookup (index->table, name) == object)
+        g_hash_table_remove (index->table, name);
+}
+
+void
+_cafe_mixer_name_index_clear (CafeMixerNameIndex *index)
+{
+    g_return_if_fail (index != NULL);
+
+    g_hash_table_remove_all (index->table);
+}
+
+gpointer
+_cafe_mixer_name_index_lookup (CafeMixerNameIndex *index, const gchar *name)
+{
+    g_return_val_if_fail (index != NULL, NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    return g_hash_table_lookup (index->table, name);
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAFEMIXER_NAME_INDEX_H
+#define CAFEMIXER_NAME_INDEX_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CafeMixerNameIndex  CafeMixerNameIndex;
+
+CafeMixerNameIndex *_cafe_mixer_name_index_new    (void);
+void                _cafe_mixer_name_index_free   (CafeMixerNameIndex *index);
+
+void                _cafe_mixer_name_index_insert (CafeMixerNameIndex *index,
+                                                   const gchar        *name,
+                                                   gpointer            object);
+void                _cafe_mixer_name_index_remove (CafeMixerNameIndex *index,
+                                                   const gchar        *name,
+                                                   gpointer            object);
+void                _cafe_mixer_name_index_clear  (CafeMixerNameIndex *index);
+
+gpointer            _cafe_mixer_name_index_lookup (CafeMixerNameIndex *index,
+                                                   const gchar        *name);
+
+G_END_DECLS
+
+#endif /* CAFEMIXER_NAME_INDEX_H */
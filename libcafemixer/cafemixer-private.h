@@ -25,6 +25,7 @@
 #include "cafemixer-app-info-private.h"
 #include "cafemixer-backend.h"
 #include "cafemixer-backend-module.h"
+#include "cafemixer-device-private.h"
 #include "cafemixer-stream-private.h"
 #include "cafemixer-stream-control-private.h"
 #include "cafemixer-switch-private.h"
@@ -108,6 +109,8 @@ G_BEGIN_DECLS
 
 const GList *_cafe_mixer_list_modules        (void);
 
+void         _cafe_mixer_backend_freeze_control (CafeMixerStreamControl *control);
+
 guint32      _cafe_mixer_create_channel_mask (const CafeMixerChannelPosition *positions,
                                               guint                           n) G_GNUC_PURE;
 
@@ -23,6 +23,7 @@
 #include "cafemixer-stream.h"
 #include "cafemixer-stream-control.h"
 #include "cafemixer-stream-control-private.h"
+#include "cafemixer-private.h"
 
 /**
  * SECTION:cafemixer-stream-control
@@ -40,6 +41,10 @@ struct _CafeMixerStreamControlPrivate
     CafeMixerStreamControlFlags     flags;
     CafeMixerStreamControlRole      role;
     CafeMixerStreamControlMediaRole media_role;
+    guint                           write_interval;
+    GSource                        *write_source;
+    gboolean                        write_pending;
+    guint                           pending_volume;
 };
 
 enum {
@@ -75,16 +80,23 @@ static void cafe_mixer_stream_control_set_property (GObject
                                                     const GValue                *value,
                                                     GParamSpec                  *pspec);
 
+static void cafe_mixer_stream_control_dispose      (GObject                     *object);
 static void cafe_mixer_stream_control_finalize     (GObject                     *object);
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (CafeMixerStreamControl, cafe_mixer_stream_control, G_TYPE_OBJECT)
 
+static gboolean set_volume_throttled (CafeMixerStreamControl *control,
+                                      guint                   volume);
+static gboolean write_timeout        (CafeMixerStreamControl *control);
+static void     flush_pending_volume (CafeMixerStreamControl *control);
+
 static void
 cafe_mixer_stream_control_class_init (CafeMixerStreamControlClass *klass)
 {
     GObjectClass *object_class;
 
     object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose      = cafe_mixer_stream_control_dispose;
     object_class->finalize     = cafe_mixer_stream_control_finalize;
     object_class->get_property = cafe_mixer_stream_control_get_property;
     object_class->set_property = cafe_mixer_stream_control_set_property;
@@ -284,6 +296,24 @@ cafe_mixer_stream_control_init (CafeMixerStreamControl *control)
     control->priv = cafe_mixer_stream_control_get_instance_private (control);
 }
 
+static void
+cafe_mixer_stream_control_dispose (GObject *object)
+{
+    CafeMixerStreamControl *control;
+
+    control = CAFE_MIXER_STREAM_CONTROL (object);
+
+    /* The subclass has already been disposed, so a pending write cannot be
+     * sent anymore */
+    if (control->priv->write_source != NULL) {
+        g_source_destroy (control->priv->write_source);
+        g_clear_pointer (&control->priv->write_source, g_source_unref);
+    }
+    control->priv->write_pending = FALSE;
+
+    G_OBJECT_CLASS (cafe_mixer_stream_control_parent_class)->dispose (object);
+}
+
 static void
 cafe_mixer_stream_control_finalize (GObject *object)
 {
@@ -445,6 +475,8 @@ cafe_mixer_stream_control_set_mute (CafeMixerStreamControl *control, gboolean mu
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+
         /* Implementation required when the flag is available */
         if (klass->set_mute (control, mute) == FALSE)
             return FALSE;
@@ -487,6 +519,10 @@ cafe_mixer_stream_control_get_volume (CafeMixerStreamControl *control)
     klass = CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
     if (control->priv->flags & CAFE_MIXER_STREAM_CONTROL_VOLUME_READABLE) {
+        /* Report the value which is going to be written */
+        if (control->priv->write_pending == TRUE)
+            return control->priv->pending_volume;
+
         /* Implementation required when the flag is available */
         return klass->get_volume (control);
     }
@@ -507,6 +543,11 @@ cafe_mixer_stream_control_set_volume (CafeMixerStreamControl *control, guint vol
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+
+        if (control->priv->write_interval > 0)
+            return set_volume_throttled (control, volume);
+
         /* Implementation required when the flag is available */
         return klass->set_volume (control, volume);
     }
@@ -548,6 +589,9 @@ cafe_mixer_stream_control_set_decibel (CafeMixerStreamControl *control, gdouble
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+        flush_pending_volume (control);
+
         /* Implementation required when the flags are available */
         return klass->set_decibel (control, decibel);
     }
@@ -633,6 +677,9 @@ cafe_mixer_stream_control_set_channel_volume (CafeMixerStreamControl *control,
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+        flush_pending_volume (control);
+
         /* Implementation required when the flag is available */
         return klass->set_channel_volume (control, channel, volume);
     }
@@ -678,6 +725,9 @@ cafe_mixer_stream_control_set_channel_decibel (CafeMixerStreamControl *control,
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+        flush_pending_volume (control);
+
         /* Implementation required when the flags are available */
         return klass->set_channel_decibel (control, channel, decibel);
     }
@@ -717,6 +767,9 @@ cafe_mixer_stream_control_set_balance (CafeMixerStreamControl *control, gfloat b
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+        flush_pending_volume (control);
+
         /* Implementation required when the flag is available */
         if (klass->set_balance (control, balance) == FALSE)
             return FALSE;
@@ -759,6 +812,9 @@ cafe_mixer_stream_control_set_fade (CafeMixerStreamControl *control, gfloat fade
         CafeMixerStreamControlClass *klass =
             CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
 
+        _cafe_mixer_backend_freeze_control (control);
+        flush_pending_volume (control);
+
         /* Implementation required when the flag is available */
         if (klass->set_fade (control, fade) == FALSE)
             return FALSE;
@@ -856,6 +912,131 @@ cafe_mixer_stream_control_get_base_volume (CafeMixerStreamControl *control)
     return CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control)->get_base_volume (control);
 }
 
+/**
+ * cafe_mixer_stream_control_get_write_interval:
+ * @control: a #CafeMixerStreamControl
+ *
+ * Gets the minimum interval between two volume changes sent to the sound
+ * system, see cafe_mixer_stream_control_set_write_interval().
+ *
+ * Returns: the interval in milliseconds or 0 if volume changes are not limited.
+ */
+guint
+cafe_mixer_stream_control_get_write_interval (CafeMixerStreamControl *control)
+{
+    g_return_val_if_fail (CAFE_MIXER_IS_STREAM_CONTROL (control), 0);
+
+    return control->priv->write_interval;
+}
+
+/**
+ * cafe_mixer_stream_control_set_write_interval:
+ * @control: a #CafeMixerStreamControl
+ * @interval: the interval in milliseconds or 0 to disable the limit
+ *
+ * Limits the rate of volume changes sent to the sound system by
+ * cafe_mixer_stream_control_set_volume().
+ *
+ * When a volume is set within @interval milliseconds after the previous
+ * change, it is held back and only the most recent of the held back values is
+ * sent when the interval elapses. This is useful when the volume is bound to
+ * a slider or a hardware knob which may produce changes at a high rate.
+ *
+ * While a change is being held back, cafe_mixer_stream_control_get_volume()
+ * returns the value which is going to be set and the #CafeMixerStreamControl:volume
+ * property is notified when this value changes. The held back change is sent
+ * from the thread-default main context of the caller.
+ *
+ * Setting the interval to 0, which is the default, sends a held back change
+ * immediately and makes all the further changes be sent right away.
+ */
+void
+cafe_mixer_stream_control_set_write_interval (CafeMixerStreamControl *control,
+                                              guint                   interval)
+{
+    g_return_if_fail (CAFE_MIXER_IS_STREAM_CONTROL (control));
+
+    if (control->priv->write_interval == interval)
+        return;
+
+    control->priv->write_interval = interval;
+
+    /* The next change starts a new interval */
+    if (control->priv->write_source != NULL) {
+        g_source_destroy (control->priv->write_source);
+        g_clear_pointer (&control->priv->write_source, g_source_unref);
+    }
+    flush_pending_volume (control);
+}
+
+static gboolean
+set_volume_throttled (CafeMixerStreamControl *control, guint volume)
+{
+    CafeMixerStreamControlClass *klass;
+
+    /* Another change has been sent recently, keep the value until the
+     * interval elapses and overwrite any value which has been kept before */
+    if (control->priv->write_source != NULL) {
+        guint current = cafe_mixer_stream_control_get_volume (control);
+
+        control->priv->pending_volume = volume;
+        control->priv->write_pending  = TRUE;
+
+        /* The volume reported by the control changes right away */
+        if (current != volume)
+            g_object_notify_by_pspec (G_OBJECT (control), properties[PROP_VOLUME]);
+        return TRUE;
+    }
+
+    klass = CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+
+    if (klass->set_volume (control, volume) == FALSE)
+        return FALSE;
+
+    control->priv->write_source = g_timeout_source_new (control->priv->write_interval);
+    g_source_set_callback (control->priv->write_source,
+                           (GSourceFunc) write_timeout,
+                           control,
+                           NULL);
+    g_source_attach (control->priv->write_source,
+                     g_main_context_get_thread_default ());
+    return TRUE;
+}
+
+static gboolean
+write_timeout (CafeMixerStreamControl *control)
+{
+    if (control->priv->write_pending == FALSE) {
+        g_clear_pointer (&control->priv->write_source, g_source_unref);
+        return G_SOURCE_REMOVE;
+    }
+
+    flush_pending_volume (control);
+
+    /* Keep the timer running, so the change just sent also delays the
+     * next one */
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+flush_pending_volume (CafeMixerStreamControl *control)
+{
+    CafeMixerStreamControlClass *klass;
+
+    if (control->priv->write_pending == FALSE)
+        return;
+
+    control->priv->write_pending = FALSE;
+
+    /* The control might have become read-only in the meantime */
+    if ((control->priv->flags & CAFE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE) == 0)
+        return;
+
+    klass = CAFE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+
+    klass->set_volume (control, control->priv->pending_volume);
+}
+
 /* Protected functions */
 void
 _cafe_mixer_stream_control_set_flags (CafeMixerStreamControl     *control,
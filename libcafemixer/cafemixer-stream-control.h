@@ -190,6 +190,10 @@ guint                           cafe_mixer_stream_control_get_max_volume       (
 guint                           cafe_mixer_stream_control_get_normal_volume    (CafeMixerStreamControl  *control);
 guint                           cafe_mixer_stream_control_get_base_volume      (CafeMixerStreamControl  *control);
 
+guint                           cafe_mixer_stream_control_get_write_interval   (CafeMixerStreamControl  *control);
+void                            cafe_mixer_stream_control_set_write_interval   (CafeMixerStreamControl  *control,
+                                                                                guint                    interval);
+
 G_END_DECLS
 
 #endif /* CAFEMIXER_STREAM_CONTROL_H */
@@ -27,6 +27,16 @@ G_BEGIN_DECLS
 void _cafe_mixer_stream_set_default_control (CafeMixerStream        *stream,
                                              CafeMixerStreamControl *control);
 
+void _cafe_mixer_stream_index_control       (CafeMixerStream        *stream,
+                                             CafeMixerStreamControl *control);
+void _cafe_mixer_stream_unindex_control     (CafeMixerStream        *stream,
+                                             CafeMixerStreamControl *control);
+
+void _cafe_mixer_stream_index_switch        (CafeMixerStream        *stream,
+                                             CafeMixerStreamSwitch  *swtch);
+void _cafe_mixer_stream_unindex_switch      (CafeMixerStream        *stream,
+                                             CafeMixerStreamSwitch  *swtch);
+
 G_END_DECLS
 
 #endif /* CAFEMIXER_STREAM_PRIVATE_H */
@@ -22,6 +22,7 @@
 #include "cafemixer-device.h"
 #include "cafemixer-enums.h"
 #include "cafemixer-enum-types.h"
+#include "cafemixer-name-index.h"
 #include "cafemixer-stream.h"
 #include "cafemixer-stream-control.h"
 #include "cafemixer-stream-private.h"
@@ -40,6 +41,8 @@ struct _CafeMixerStreamPrivate
     CafeMixerDirection      direction;
     CafeMixerDevice        *device;
     CafeMixerStreamControl *control;
+    CafeMixerNameIndex     *controls_index;
+    CafeMixerNameIndex     *switches_index;
 };
 
 enum {
@@ -283,6 +286,13 @@ cafe_mixer_stream_dispose (GObject *object)
 
     g_clear_object (&stream->priv->control);
 
+    /* Subclasses release their elements without removing them from the
+     * indexes when they are disposed */
+    if (stream->priv->controls_index != NULL)
+        _cafe_mixer_name_index_clear (stream->priv->controls_index);
+    if (stream->priv->switches_index != NULL)
+        _cafe_mixer_name_index_clear (stream->priv->switches_index);
+
     G_OBJECT_CLASS (cafe_mixer_stream_parent_class)->dispose (object);
 }
 
@@ -296,6 +306,11 @@ cafe_mixer_stream_finalize (GObject *object)
     g_free (stream->priv->name);
     g_free (stream->priv->label);
 
+    if (stream->priv->controls_index != NULL)
+        _cafe_mixer_name_index_free (stream->priv->controls_index);
+    if (stream->priv->switches_index != NULL)
+        _cafe_mixer_name_index_free (stream->priv->switches_index);
+
     G_OBJECT_CLASS (cafe_mixer_stream_parent_class)->finalize (object);
 }
 
@@ -390,11 +405,15 @@ cafe_mixer_stream_get_default_control (CafeMixerStream *stream)
 
     g_return_val_if_fail (CAFE_MIXER_IS_STREAM (stream), NULL);
 
+    /* Always list the controls, even when the default one is known, so the
+     * backend sees the stream is in use; listing may also make the backend
+     * load the controls and select the default one */
+    list = cafe_mixer_stream_list_controls (stream);
+
     if (stream->priv->control != NULL)
         return stream->priv->control;
 
     /* If the stream does not have a default control, just return the first one */
-    list = cafe_mixer_stream_list_controls (stream);
     if (list != NULL)
         return CAFE_MIXER_STREAM_CONTROL (list->data);
 
@@ -447,6 +466,10 @@ cafe_mixer_stream_real_get_control (CafeMixerStream *stream, const gchar *name)
     g_return_val_if_fail (CAFE_MIXER_IS_STREAM (stream), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
+    /* The index is authoritative once the subclass started feeding it */
+    if (stream->priv->controls_index != NULL)
+        return _cafe_mixer_name_index_lookup (stream->priv->controls_index, name);
+
     list = cafe_mixer_stream_list_controls (stream);
     while (list != NULL) {
         CafeMixerStreamControl *control = CAFE_MIXER_STREAM_CONTROL (list->data);
@@ -467,6 +490,9 @@ cafe_mixer_stream_real_get_switch (CafeMixerStream *stream, const gchar *name)
     g_return_val_if_fail (CAFE_MIXER_IS_STREAM (stream), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
+    if (stream->priv->switches_index != NULL)
+        return _cafe_mixer_name_index_lookup (stream->priv->switches_index, name);
+
     list = cafe_mixer_stream_list_switches (stream);
     while (list != NULL) {
         CafeMixerSwitch *swtch = CAFE_MIXER_SWITCH (list->data);
@@ -508,3 +534,65 @@ _cafe_mixer_stream_set_default_control (CafeMixerStream        *stream,
 
     g_object_notify_by_pspec (G_OBJECT (stream), properties[PROP_DEFAULT_CONTROL]);
 }
+
+/*
+ * Subclasses which keep track of their controls and switches may feed the name
+ * indexes using the following functions, the default get_control and get_switch
+ * implementations then avoid walking the lists.
+ *
+ * When a subclass indexes any element, it must index all of them and remove
+ * them from the index when they are removed from the stream.
+ */
+void
+_cafe_mixer_stream_index_control (CafeMixerStream        *stream,
+                                  CafeMixerStreamControl *control)
+{
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM_CONTROL (control));
+
+    if (stream->priv->controls_index == NULL)
+        stream->priv->controls_index = _cafe_mixer_name_index_new ();
+
+    _cafe_mixer_name_index_insert (stream->priv->controls_index,
+                                   cafe_mixer_stream_control_get_name (control),
+                                   control);
+}
+
+void
+_cafe_mixer_stream_unindex_control (CafeMixerStream        *stream,
+                                    CafeMixerStreamControl *control)
+{
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM_CONTROL (control));
+
+    if (stream->priv->controls_index != NULL)
+        _cafe_mixer_name_index_remove (stream->priv->controls_index,
+                                       cafe_mixer_stream_control_get_name (control),
+                                       control);
+}
+
+void
+_cafe_mixer_stream_index_switch (CafeMixerStream *stream, CafeMixerStreamSwitch *swtch)
+{
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM_SWITCH (swtch));
+
+    if (stream->priv->switches_index == NULL)
+        stream->priv->switches_index = _cafe_mixer_name_index_new ();
+
+    _cafe_mixer_name_index_insert (stream->priv->switches_index,
+                                   cafe_mixer_switch_get_name (CAFE_MIXER_SWITCH (swtch)),
+                                   swtch);
+}
+
+void
+_cafe_mixer_stream_unindex_switch (CafeMixerStream *stream, CafeMixerStreamSwitch *swtch)
+{
+    g_return_if_fail (CAFE_MIXER_IS_STREAM (stream));
+    g_return_if_fail (CAFE_MIXER_IS_STREAM_SWITCH (swtch));
+
+    if (stream->priv->switches_index != NULL)
+        _cafe_mixer_name_index_remove (stream->priv->switches_index,
+                                       cafe_mixer_switch_get_name (CAFE_MIXER_SWITCH (swtch)),
+                                       swtch);
+}
@@ -27,6 +27,9 @@ G_BEGIN_DECLS
 void _cafe_mixer_switch_set_active_option (CafeMixerSwitch       *sw,
                                            CafeMixerSwitchOption *option);
 
+void _cafe_mixer_switch_index_option      (CafeMixerSwitch       *sw,
+                                           CafeMixerSwitchOption *option);
+
 G_END_DECLS
 
 #endif /* CAFEMIXER_SWITCH_PRIVATE_H */
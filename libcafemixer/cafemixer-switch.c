@@ -21,6 +21,7 @@
 
 #include "cafemixer-enums.h"
 #include "cafemixer-enum-types.h"
+#include "cafemixer-name-index.h"
 #include "cafemixer-switch.h"
 #include "cafemixer-switch-private.h"
 #include "cafemixer-switch-option.h"
@@ -35,6 +36,7 @@ struct _CafeMixerSwitchPrivate
     gchar                 *name;
     gchar                 *label;
     CafeMixerSwitchOption *active;
+    CafeMixerNameIndex    *options_index;
 };
 
 enum {
@@ -179,6 +181,9 @@ cafe_mixer_switch_dispose (GObject *object)
 
     g_clear_object (&swtch->priv->active);
 
+    if (swtch->priv->options_index != NULL)
+        _cafe_mixer_name_index_clear (swtch->priv->options_index);
+
     G_OBJECT_CLASS (cafe_mixer_switch_parent_class)->dispose (object);
 }
 
@@ -192,6 +197,9 @@ cafe_mixer_switch_finalize (GObject *object)
     g_free (swtch->priv->name);
     g_free (swtch->priv->label);
 
+    if (swtch->priv->options_index != NULL)
+        _cafe_mixer_name_index_free (swtch->priv->options_index);
+
     G_OBJECT_CLASS (cafe_mixer_switch_parent_class)->finalize (object);
 }
 
@@ -336,6 +344,21 @@ _cafe_mixer_switch_set_active_option (CafeMixerSwitch       *swtch,
     g_object_notify_by_pspec (G_OBJECT (swtch), properties[PROP_ACTIVE_OPTION]);
 }
 
+void
+_cafe_mixer_switch_index_option (CafeMixerSwitch       *swtch,
+                                 CafeMixerSwitchOption *option)
+{
+    g_return_if_fail (CAFE_MIXER_IS_SWITCH (swtch));
+    g_return_if_fail (CAFE_MIXER_IS_SWITCH_OPTION (option));
+
+    if (swtch->priv->options_index == NULL)
+        swtch->priv->options_index = _cafe_mixer_name_index_new ();
+
+    _cafe_mixer_name_index_insert (swtch->priv->options_index,
+                                   cafe_mixer_switch_option_get_name (option),
+                                   option);
+}
+
 static CafeMixerSwitchOption *
 cafe_mixer_switch_real_get_option (CafeMixerSwitch *swtch, const gchar *name)
 {
@@ -344,6 +367,10 @@ cafe_mixer_switch_real_get_option (CafeMixerSwitch *swtch, const gchar *name)
     g_return_val_if_fail (CAFE_MIXER_IS_SWITCH (swtch), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
+    /* The index is authoritative once the subclass started feeding it */
+    if (swtch->priv->options_index != NULL)
+        return _cafe_mixer_name_index_lookup (swtch->priv->options_index, name);
+
     list = cafe_mixer_switch_list_options (swtch);
     while (list != NULL) {
         CafeMixerSwitchOption *option = CAFE_MIXER_SWITCH_OPTION (list->data);
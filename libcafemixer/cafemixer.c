@@ -17,7 +17,9 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <glib-object.h>
 #include <gmodule.h>
 
@@ -32,18 +34,43 @@
  * @see_also: #CafeMixerContext
  *
  * The libcafemixer library must be initialized before it is used by an
- * application. The initialization function loads dynamic modules which provide
+ * application. The initialization function finds dynamic modules which provide
  * access to sound systems (also called backends) and it only succeeds if there
  * is at least one usable module present on the target system.
  *
+ * Information about each module is kept in a small manifest in the user's
+ * cache directory, so that a module is only loaded when a context actually
+ * tries to use it. Modules which have been found unusable are also recorded
+ * in the manifest and skipped until the module file changes.
+ *
  * To connect to a sound system and access the mixer functionality after the
  * library is initialized, create a #CafeMixerContext using the
  * cafe_mixer_context_new() function.
  */
 
-static void       load_modules     (void);
-static gint       compare_modules  (gconstpointer a,
-                                    gconstpointer b);
+static void       load_modules        (void);
+static gint       compare_modules     (gconstpointer               a,
+                                       gconstpointer               b);
+
+#ifdef BUILTIN_BACKENDS
+static void       load_builtin_modules (void);
+#else
+static gchar     *get_manifest_path   (void);
+static gboolean   is_manifest_current (GKeyFile                   *manifest,
+                                       const gchar                *group,
+                                       const GStatBuf             *st);
+static gboolean   read_manifest_info  (GKeyFile                   *manifest,
+                                       const gchar                *group,
+                                       const GStatBuf             *st,
+                                       CafeMixerBackendInfo       *info);
+static void       write_manifest_info (GKeyFile                   *manifest,
+                                       const gchar                *group,
+                                       const GStatBuf             *st,
+                                       const CafeMixerBackendInfo *info);
+static void       write_manifest_stat (GKeyFile                   *manifest,
+                                       const gchar                *group,
+                                       const GStatBuf             *st);
+#endif
 
 static GList     *modules = NULL;
 static gboolean   initialized = FALSE;
@@ -66,28 +93,11 @@ cafe_mixer_init (void)
     load_modules ();
 
     if (modules != NULL) {
-        GList *list = modules;
-
-        while (list != NULL) {
-            GTypeModule *module = G_TYPE_MODULE (list->data);
-            GList       *next = list->next;
-
-            /* Load the plugin and remove it from the list if it fails */
-            if (g_type_module_use (module) == FALSE) {
-                g_object_unref (module);
-                modules = g_list_delete_link (modules, list);
-            }
-            list = next;
-        }
-
-        if (modules != NULL) {
-            /* Sort the usable modules by priority */
-            modules = g_list_sort (modules, compare_modules);
-            initialized = TRUE;
-        } else
-            g_critical ("No usable backend modules have been found");
+        /* Sort the usable modules by priority */
+        modules = g_list_sort (modules, compare_modules);
+        initialized = TRUE;
     } else
-        g_critical ("No backend modules have been found");
+        g_critical ("No usable backend modules have been found");
 
     return initialized;
 }
@@ -108,7 +118,8 @@ cafe_mixer_is_initialized (void)
 /**
  * _cafe_mixer_list_modules:
  *
- * Gets a list of loaded backend modules.
+ * Gets a list of usable backend modules sorted by priority. The modules might
+ * not be loaded yet, see cafe_mixer_backend_module_load().
  *
  * Returns: a #GList.
  */
@@ -149,6 +160,10 @@ load_modules (void)
     if (loaded == TRUE)
         return;
 
+#ifdef BUILTIN_BACKENDS
+    /* The backends are a part of the library, there is nothing to look for */
+    load_builtin_modules ();
+#else
     if (G_LIKELY (g_module_supported () == TRUE)) {
         GDir   *dir;
         GError *error = NULL;
@@ -158,20 +173,100 @@ load_modules (void)
         dir = g_dir_open (LIBCAFEMIXER_BACKEND_DIR, 0, &error);
         if (dir != NULL) {
             const gchar *name;
+            gchar       *path;
+            GKeyFile    *manifest;
+            GKeyFile    *updated;
+            gsize        n_groups = 0;
+            guint        n_matched = 0;
+            guint        n_written = 0;
+            gchar      **groups;
+
+            path     = get_manifest_path ();
+            manifest = g_key_file_new ();
+            updated  = g_key_file_new ();
+
+            g_key_file_load_from_file (manifest, path, G_KEY_FILE_NONE, NULL);
 
             while ((name = g_dir_read_name (dir)) != NULL) {
-                gchar *file;
+                CafeMixerBackendModule *module;
+                CafeMixerBackendInfo    info;
+                GStatBuf                st;
+                gchar                  *file;
 
                 if (g_str_has_suffix (name, "." G_MODULE_SUFFIX) == FALSE)
                     continue;
 
                 file = g_build_filename (LIBCAFEMIXER_BACKEND_DIR, name, NULL);
-                modules = g_list_prepend (modules,
-                                          cafe_mixer_backend_module_new (file));
+
+                if (g_stat (file, &st) != 0) {
+                    g_free (file);
+                    continue;
+                }
+
+                if (is_manifest_current (manifest, name, &st) == TRUE &&
+                    g_key_file_has_key (manifest, name, "Usable", NULL) == TRUE &&
+                    g_key_file_get_boolean (manifest, name, "Usable", NULL) == FALSE) {
+                    /* The module has been found unusable before and has not
+                     * changed since, do not try to load it again */
+                    module = NULL;
+
+                    n_matched++;
+                } else if (read_manifest_info (manifest, name, &st, &info) == TRUE) {
+                    /* The manifest entry is up to date, so the module can be
+                     * sorted without loading it */
+                    module = cafe_mixer_backend_module_new_from_manifest (file, &info);
+                    g_free (info.name);
+
+                    n_matched++;
+                } else {
+                    /* A new or modified module, load it to find out its
+                     * properties and skip it if it is not usable */
+                    module = cafe_mixer_backend_module_new (file);
+
+                    if (cafe_mixer_backend_module_load (module) == FALSE)
+                        g_clear_object (&module);
+                }
                 g_free (file);
+
+                n_written++;
+
+                if (module == NULL) {
+                    write_manifest_stat (updated, name, &st);
+                    g_key_file_set_boolean (updated, name, "Usable", FALSE);
+                    continue;
+                }
+
+                write_manifest_info (updated,
+                                     name,
+                                     &st,
+                                     cafe_mixer_backend_module_get_info (module));
+
+                modules = g_list_prepend (modules, module);
             }
 
             g_dir_close (dir);
+
+            /* Save the manifest if a module has been added, modified or removed */
+            groups = g_key_file_get_groups (manifest, &n_groups);
+
+            if (n_matched != n_groups || n_matched != n_written) {
+                gchar *dirname = g_path_get_dirname (path);
+
+                if (g_mkdir_with_parents (dirname, 0700) != 0 ||
+                    g_key_file_save_to_file (updated, path, &error) == FALSE) {
+                    g_debug ("Failed to save backend module manifest %s: %s",
+                             path,
+                             (error != NULL) ? error->message : g_strerror (errno));
+
+                    g_clear_error (&error);
+                }
+                g_free (dirname);
+            }
+
+            g_strfreev (groups);
+            g_key_file_free (manifest);
+            g_key_file_free (updated);
+            g_free (path);
         } else {
             g_critical ("%s", error->message);
             g_error_free (error);
@@ -179,6 +274,7 @@ load_modules (void)
     } else {
         g_critical ("Unable to load backend modules: Not supported");
     }
+#endif
 
     loaded = TRUE;
 }
@@ -195,3 +291,148 @@ compare_modules (gconstpointer a, gconstpointer b)
 
     return info2->priority - info1->priority;
 }
+
+#ifdef BUILTIN_BACKENDS
+#ifdef HAVE_NULL
+void                        null_backend_module_init      (GTypeModule *module);
+const CafeMixerBackendInfo *null_backend_module_get_info  (void);
+#endif
+#ifdef HAVE_PULSEAUDIO
+void                        pulse_backend_module_init     (GTypeModule *module);
+const CafeMixerBackendInfo *pulse_backend_module_get_info (void);
+#endif
+#ifdef HAVE_ALSA
+void                        alsa_backend_module_init      (GTypeModule *module);
+const CafeMixerBackendInfo *alsa_backend_module_get_info  (void);
+#endif
+#ifdef HAVE_OSS
+void                        oss_backend_module_init       (GTypeModule *module);
+const CafeMixerBackendInfo *oss_backend_module_get_info   (void);
+#endif
+
+static const struct {
+    const gchar                 *name;
+    CafeMixerBackendInitFunc     init;
+    CafeMixerBackendGetInfoFunc  get_info;
+} builtin_backends[] = {
+#ifdef HAVE_NULL
+    { "null",  null_backend_module_init,  null_backend_module_get_info },
+#endif
+#ifdef HAVE_PULSEAUDIO
+    { "pulse", pulse_backend_module_init, pulse_backend_module_get_info },
+#endif
+#ifdef HAVE_ALSA
+    { "alsa",  alsa_backend_module_init,  alsa_backend_module_get_info },
+#endif
+#ifdef HAVE_OSS
+    { "oss",   oss_backend_module_init,   oss_backend_module_get_info },
+#endif
+    { NULL, NULL, NULL }
+};
+
+static void
+load_builtin_modules (void)
+{
+    guint i;
+
+    for (i = 0; builtin_backends[i].name != NULL; i++) {
+        CafeMixerBackendModule *module;
+
+        module = cafe_mixer_backend_module_new_builtin (builtin_backends[i].name,
+                                                        builtin_backends[i].init,
+                                                        builtin_backends[i].get_info);
+
+        /* Registering the types of a built-in backend is cheap, so there is no
+         * reason to defer it */
+        if (cafe_mixer_backend_module_load (module) == FALSE) {
+            g_object_unref (module);
+            continue;
+        }
+        modules = g_list_prepend (modules, module);
+    }
+}
+#else
+/* The manifest is specific to the backend directory, so that libraries installed
+ * in different prefixes or for different architectures do not share it */
+static gchar *
+get_manifest_path (void)
+{
+    gchar *checksum;
+    gchar *name;
+    gchar *path;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_MD5, LIBCAFEMIXER_BACKEND_DIR, -1);
+    name     = g_strdup_printf ("modules-%s.ini", checksum);
+    path     = g_build_filename (g_get_user_cache_dir (), "libcafemixer", name, NULL);
+
+    g_free (checksum);
+    g_free (name);
+    return path;
+}
+
+/* Entries are ignored if the module file has changed since they were written */
+static gboolean
+is_manifest_current (GKeyFile       *manifest,
+                     const gchar    *group,
+                     const GStatBuf *st)
+{
+    if (g_key_file_has_key (manifest, group, "MTime", NULL) == FALSE ||
+        g_key_file_has_key (manifest, group, "Size", NULL) == FALSE)
+        return FALSE;
+
+    return g_key_file_get_int64 (manifest, group, "MTime", NULL) == (gint64) st->st_mtime &&
+           g_key_file_get_int64 (manifest, group, "Size", NULL) == (gint64) st->st_size;
+}
+
+static gboolean
+read_manifest_info (GKeyFile             *manifest,
+                    const gchar          *group,
+                    const GStatBuf       *st,
+                    CafeMixerBackendInfo *info)
+{
+    static const gchar *keys[] = {
+        "Name", "Priority", "Type", "Flags", NULL
+    };
+    guint i;
+
+    if (is_manifest_current (manifest, group, st) == FALSE)
+        return FALSE;
+
+    for (i = 0; keys[i] != NULL; i++)
+        if (g_key_file_has_key (manifest, group, keys[i], NULL) == FALSE)
+            return FALSE;
+
+    info->name = g_key_file_get_string (manifest, group, "Name", NULL);
+    if (G_UNLIKELY (info->name == NULL))
+        return FALSE;
+
+    info->priority      = g_key_file_get_integer (manifest, group, "Priority", NULL);
+    info->backend_type  = g_key_file_get_integer (manifest, group, "Type", NULL);
+    info->backend_flags = g_key_file_get_integer (manifest, group, "Flags", NULL);
+    info->g_type        = G_TYPE_INVALID;
+    return TRUE;
+}
+
+static void
+write_manifest_info (GKeyFile                   *manifest,
+                     const gchar                *group,
+                     const GStatBuf             *st,
+                     const CafeMixerBackendInfo *info)
+{
+    g_key_file_set_string (manifest, group, "Name", info->name);
+    g_key_file_set_integer (manifest, group, "Priority", info->priority);
+    g_key_file_set_integer (manifest, group, "Type", info->backend_type);
+    g_key_file_set_integer (manifest, group, "Flags", info->backend_flags);
+
+    write_manifest_stat (manifest, group, st);
+}
+
+static void
+write_manifest_stat (GKeyFile       *manifest,
+                     const gchar    *group,
+                     const GStatBuf *st)
+{
+    g_key_file_set_int64 (manifest, group, "MTime", st->st_mtime);
+    g_key_file_set_int64 (manifest, group, "Size", st->st_size);
+}
+#endif